@@ -0,0 +1,14 @@
+#include "shape.h"
+
+class Circle : public Shape {
+  double r;
+public:
+  Circle(double r) : r(r) { }
+  virtual double area() const {
+    return 3.0 * r * r;
+  }
+};
+
+inline Shape *new_unit_circle() {
+  return new Circle(1.0);
+}
@@ -0,0 +1,9 @@
+%module circle
+%{
+#include "circle.h"
+%}
+
+%import shape.i
+
+%newobject new_unit_circle;
+%include circle.h
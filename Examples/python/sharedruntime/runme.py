@@ -0,0 +1,13 @@
+# file: runme.py
+# Both modules use the runtime code and type registry of libswigrun
+
+import shape
+import circle
+
+c = circle.Circle(2.0)
+u = circle.new_unit_circle()
+
+# A Circle from one module is accepted where the other module expects a Shape
+print("Total area: %g" % shape.total_area(c, u))
+if shape.total_area(c, u) != 15.0:
+    raise RuntimeError("wrong total area")
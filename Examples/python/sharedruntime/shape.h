@@ -0,0 +1,11 @@
+class Shape {
+public:
+  virtual ~Shape() { }
+  virtual double area() const {
+    return 0.0;
+  }
+};
+
+inline double total_area(const Shape *a, const Shape *b) {
+  return a->area() + b->area();
+}
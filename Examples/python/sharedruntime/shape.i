@@ -0,0 +1,6 @@
+%module shape
+%{
+#include "shape.h"
+%}
+
+%include shape.h
@@ -345,6 +345,7 @@ CPP_TEST_CASES += \
 	overload_complicated \
 	overload_copy \
 	overload_extend \
+	overload_implicitconv \
 	overload_method \
 	overload_numeric \
 	overload_null \
@@ -355,6 +356,7 @@ CPP_TEST_CASES += \
 	overload_subtype \
 	overload_template \
 	overload_template_fast \
+	pointer_cast_cache \
 	pointer_reference \
 	preproc_constants \
 	primitive_ref \
@@ -537,6 +539,7 @@ CPP_TEST_CASES += \
 	types_directive \
 	unicode_strings \
 	union_scope \
+	upcast_virtual_base \
 	using1 \
 	using2 \
 	using_composition \
@@ -102,3 +102,11 @@ struct RawStringDoc {
 };
 %}
 
+// Raw strings in skipped function bodies
+%inline %{
+struct RawStringBody {
+  const char *brace() const { return R"({ "not a } brace)"; }
+  const char *quote() const { return R"DELIM(")DELIM"; }
+  int after() const { return 100; }
+};
+%}
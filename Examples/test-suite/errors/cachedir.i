@@ -0,0 +1,5 @@
+%module cachedir
+
+/* Run several times by the cachedir.ctest rule in Makefile.in, which creates
+   cachedir.h in the include path directories. */
+%include "cachedir.h"
@@ -0,0 +1,32 @@
+%module xxx
+/* Line numbers after code skipped by false conditionals */
+
+#if 0
+}
+int a;
+#endif
+#if __LINE__ != 8
+#error "wrong line after an excluded block"
+#endif
+#warning "line 11"
+
+#ifdef UNDEFINED_MACRO
+{
+int c;
+x
+
+#else
+#warning "line 19"
+#endif
+#if __LINE__ != 21
+#error "wrong line after an excluded block"
+#endif
+#if 0
+
+
+  int d; /* comment */
+#endif
+#if __LINE__ != 29
+#error "wrong line after an excluded block"
+#endif
+#warning "line 32"
@@ -0,0 +1,24 @@
+%module overload_implicitconv
+
+/* Overloads taking the same number of arguments where one of them is only
+   chosen through an implicit conversion, with and without compact default
+   arguments */
+
+%implicitconv Number;
+%feature("compactdefaultargs") take_default;
+
+%inline %{
+struct Number {
+  int value;
+  Number(int v) : value(v) {}
+};
+
+struct Other {
+};
+
+int take(const Number &n) { return n.value; }
+int take(const Other &) { return -1; }
+
+int take_default(const Number &n, int extra = 0) { return n.value + extra; }
+int take_default(const Other &, int extra = 0) { return -1 - extra; }
+%}
@@ -0,0 +1,30 @@
+%module pointer_cast_cache
+
+/* Different derived types passed through the same base class argument,
+   where each needs its own pointer adjustment */
+
+%inline %{
+struct Left {
+  int left;
+  Left() : left(1) {}
+  virtual ~Left() {}
+};
+
+struct Right {
+  int right;
+  Right() : right(2) {}
+  virtual ~Right() {}
+};
+
+struct LeftRight : Left, Right {
+  int both;
+  LeftRight() : both(3) { right = 20; }
+};
+
+struct OnlyRight : Right {
+  OnlyRight() { right = 30; }
+};
+
+int get_right(Right *r) { return r->right; }
+int get_right_ref(const Right &r) { return r.right; }
+%}
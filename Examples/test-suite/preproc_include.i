@@ -50,3 +50,7 @@ nested_include_2(HEADER);
 nested_include_1(preproc_include_h1.i);
 nested_include_2(preproc_include_h2.i);
 nested_include_3(preproc_include_h3.i);
+
+// The same file found via a different path is only included once due to #pragma once
+%include "preproc_include_once.h"
+%include "./preproc_include_once.h"
@@ -0,0 +1,4 @@
+#pragma once
+%inline %{
+int multiply80(int a) { return a*80; }
+%}
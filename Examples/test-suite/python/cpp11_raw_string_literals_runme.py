@@ -73,3 +73,9 @@ on multiple lines including a \ backslash""")
 check(mm, """)I'm an "ascii" \ string constant with multiple
 
 lines.""")
+
+rsb = RawStringBody()
+check(rsb.brace(), """{ "not a } brace""")
+check(rsb.quote(), '"')
+if rsb.after() != 100:
+    raise RuntimeError
@@ -0,0 +1,17 @@
+from overload_implicitconv import *
+
+
+def check(a, b):
+    if a != b:
+        raise RuntimeError(str(a) + " does not equal " + str(b))
+
+
+check(take(Number(3)), 3)
+check(take(Other()), -1)
+check(take(5), 5)
+
+check(take_default(Number(3)), 3)
+check(take_default(Number(3), 2), 5)
+check(take_default(Other(), 2), -3)
+check(take_default(5), 5)
+check(take_default(5, 2), 7)
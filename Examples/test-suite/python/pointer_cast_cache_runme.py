@@ -0,0 +1,10 @@
+from pointer_cast_cache import *
+
+objects = [(Right(), 2), (LeftRight(), 20), (OnlyRight(), 30)]
+
+for i in range(3):
+    for obj, expected in objects + list(reversed(objects)):
+        if get_right(obj) != expected:
+            raise RuntimeError("get_right failed for {}".format(type(obj).__name__))
+        if get_right_ref(obj) != expected:
+            raise RuntimeError("get_right_ref failed for {}".format(type(obj).__name__))
@@ -20,3 +20,6 @@ if preproc_include.multiply60(10) != 600:
 
 if preproc_include.multiply70(10) != 700:
     raise RuntimeError
+
+if preproc_include.multiply80(10) != 800:
+    raise RuntimeError
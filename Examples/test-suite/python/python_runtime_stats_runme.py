@@ -0,0 +1,43 @@
+import _python_runtime_stats
+from python_runtime_stats import *
+
+stats = _python_runtime_stats._swig_stats()
+if stats["convert_ptr"] != 0 or stats["exceptions"] != 0:
+    raise RuntimeError("counters not zero at start: {}".format(stats))
+
+b = Base()
+d = Derived()
+for i in range(3):
+    get_value(b)
+    get_value(d)
+take(Derived())
+
+thrown = False
+try:
+    throw_int()
+except RuntimeError:
+    thrown = True
+if not thrown:
+    raise RuntimeError("throw_int did not throw")
+
+try:
+    get_value("not a Base")
+    raise RuntimeError("get_value did not fail")
+except TypeError:
+    pass
+
+stats = _python_runtime_stats._swig_stats()
+calls = stats["calls"]
+if calls.get("_wrap_get_value") != 7:
+    raise RuntimeError("wrong get_value count: {}".format(calls))
+if calls.get("_wrap_new_Derived") != 2 or calls.get("_wrap_take") != 1:
+    raise RuntimeError("wrong call counts: {}".format(calls))
+if stats["convert_ptr"] < 8:
+    raise RuntimeError("wrong convert_ptr count: {}".format(stats))
+if stats["cast_checks"] < 1 or stats["cast_steps"] < stats["cast_checks"]:
+    raise RuntimeError("wrong cast counts: {}".format(stats))
+# three objects created with ownership and one given up by take()
+if stats["ownership"] != 4:
+    raise RuntimeError("wrong ownership count: {}".format(stats))
+if stats["exceptions"] != 2:
+    raise RuntimeError("wrong exceptions count: {}".format(stats))
@@ -0,0 +1,52 @@
+import gc
+from python_track_objects import *
+
+h = Holder()
+if h.get_self() is not h:
+    raise RuntimeError("constructed object not tracked")
+
+# objects created in Python and handed to C++
+item = Item(1)
+h.add(item)
+if h.get(0) is not item or h.get_ref(0) is not item:
+    raise RuntimeError("added item not returned")
+
+# objects created in C++
+for i in range(1, 500):
+    h.add(h.make_item(i))
+first = h.get(1)
+if h.get(1) is not first:
+    raise RuntimeError("returned item not tracked")
+items = [h.get(i) for i in range(h.size())]
+for i in range(h.size()):
+    if h.get(i) is not items[i] or items[i].value != i + (1 if i == 0 else 0):
+        raise RuntimeError("wrong item {}".format(i))
+
+# a derived object returned through a base class pointer keeps its type
+special = SpecialItem(7)
+h.add(special)
+returned = h.get(h.size() - 1)
+if returned is not special or not isinstance(returned, SpecialItem):
+    raise RuntimeError("derived item not returned")
+
+# the table does not keep wrappers alive
+del items, first, returned
+gc.collect()
+again = h.get(2)
+if again.value != 2 or h.get(2) is not again:
+    raise RuntimeError("item not tracked again after its wrapper was released")
+
+# a new object allocated where a deleted one was gets a new wrapper
+for i in range(100):
+    h.add(h.make_item(1000 + i))
+    stale = h.get(h.size() - 1)
+    h.destroy_last()
+    fresh = Item(i)
+    if fresh is stale or fresh.this is stale.this or fresh.value != i or not fresh.thisown:
+        raise RuntimeError("constructor returned the wrapper of a deleted object")
+    if h.get_self() is not h:
+        raise RuntimeError("holder no longer tracked")
+    del stale, fresh
+
+if h.get_untracked() is h.get_untracked():
+    raise RuntimeError("untracked class was tracked")
@@ -41,6 +41,10 @@ if not SWIG_TypeQuery("vfncs::ArithUnaryFunction<vfncs::arith_traits<float,doubl
 if not SWIG_TypeQuery("vfncs::ArithUnaryFunction<double,double> *"):
     raise RuntimeError
 
+# spaces are not significant
+if not SWIG_TypeQuery("vfncs :: ArithUnaryFunction< double, double > *"):
+    raise RuntimeError
+
 # this is a bad name
 if SWIG_TypeQuery("vfncs::ArithUnaryFunction<double,doublex> *"):
     raise RuntimeError
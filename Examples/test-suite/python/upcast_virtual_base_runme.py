@@ -0,0 +1,12 @@
+from upcast_virtual_base import *
+
+objects = [(Base(), 1), (Derived(), 10), (MoreDerived(), 20), (OtherFirst(), 30),
+           (VirtualDerived(), 50), (Diamond(), 60), (VirtualTemplateBase(), 70),
+           (TemplateDerived(), 80)]
+
+for obj, expected in objects:
+    if get_value(obj) != expected:
+        raise RuntimeError("get_value failed for {}".format(type(obj).__name__))
+
+if get_other(OtherFirst()) != 40:
+    raise RuntimeError("get_other failed")
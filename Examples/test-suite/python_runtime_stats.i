@@ -0,0 +1,24 @@
+%module python_runtime_stats
+
+%begin %{
+#define SWIG_RUNTIME_STATS
+%}
+
+%apply SWIGTYPE *DISOWN { Base *disowned };
+%catches(int) throw_int;
+
+%inline %{
+struct Base {
+  int value;
+  Base() : value(1) {}
+  virtual ~Base() {}
+};
+
+struct Derived : Base {
+  Derived() { value = 2; }
+};
+
+int get_value(Base *b) { return b->value; }
+void take(Base *disowned) { delete disowned; }
+void throw_int() { throw 42; }
+%}
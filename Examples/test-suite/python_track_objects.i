@@ -0,0 +1,45 @@
+%module python_track_objects
+
+%trackobjects Item;
+%trackobjects SpecialItem;
+%trackobjects Holder;
+
+%newobject Holder::make_item;
+%apply SWIGTYPE *DISOWN { Item *owned };
+
+%inline %{
+#include <vector>
+
+struct Item {
+  int value;
+  Item(int v = 0) : value(v) {}
+  virtual ~Item() {}
+};
+
+struct SpecialItem : Item {
+  SpecialItem(int v = 0) : Item(v) {}
+};
+
+struct Untracked {
+  int value;
+  Untracked() : value(0) {}
+};
+
+struct Holder {
+  std::vector<Item *> items;
+  Untracked untracked;
+
+  ~Holder() {
+    for (size_t i = 0; i < items.size(); ++i)
+      delete items[i];
+  }
+  void add(Item *owned) { items.push_back(owned); }
+  void destroy_last() { delete items.back(); items.pop_back(); }
+  Item *get(int i) { return items[i]; }
+  Item &get_ref(int i) { return *items[i]; }
+  int size() const { return (int)items.size(); }
+  Item *make_item(int v) { return new Item(v); }
+  Untracked *get_untracked() { return &untracked; }
+  Holder *get_self() { return this; }
+};
+%}
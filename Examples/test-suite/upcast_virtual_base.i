@@ -0,0 +1,53 @@
+%module upcast_virtual_base
+
+/* Upcasts that leave the pointer unchanged, that need an offset and that
+   go through a virtual base, all passed to the same base class argument */
+
+%inline %{
+struct Base {
+  int value;
+  Base() : value(1) {}
+  virtual ~Base() {}
+};
+
+struct Other {
+  int other;
+  Other() : other(2) {}
+  virtual ~Other() {}
+};
+
+struct Derived : Base {
+  Derived() { value = 10; }
+};
+
+struct MoreDerived : Derived {
+  MoreDerived() { value = 20; }
+};
+
+struct OtherFirst : Other, Base {
+  OtherFirst() { value = 30; other = 40; }
+};
+
+struct VirtualDerived : virtual Base {
+  VirtualDerived() { value = 50; }
+};
+
+struct Diamond : VirtualDerived, virtual Base {
+  Diamond() { value = 60; }
+};
+
+template<typename T> struct VirtualTemplate : virtual T {
+  VirtualTemplate() { T::value = 70; }
+};
+%}
+
+%template(VirtualTemplateBase) VirtualTemplate<Base>;
+
+%inline %{
+struct TemplateDerived : VirtualTemplate<Base> {
+  TemplateDerived() { value = 80; }
+};
+
+int get_value(Base *b) { return b->value; }
+int get_other(Other *o) { return o->other; }
+%}
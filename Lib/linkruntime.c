@@ -1,22 +1,85 @@
-#ifndef SWIGEXPORT
-# if defined(_WIN32) || defined(__WIN32__) || defined(__CYGWIN__)
-#   if defined(STATIC_LINKED)
-#     define SWIGEXPORT
-#   else
-#     define SWIGEXPORT __declspec(dllexport)
-#   endif
-# else
-#   if defined(__GNUC__) && defined(GCC_HASCLASSVISIBILITY)
-#     define SWIGEXPORT __attribute__ ((visibility("default")))
-#   else
-#     define SWIGEXPORT
-#   endif
-# endif
+/* -----------------------------------------------------------------------------
+ * linkruntime.c
+ *
+ * The shared SWIG runtime library.  Modules compiled with SWIG_LINK_RUNTIME,
+ * e.g. with the -sharedruntime option of the Python module, are linked to it
+ * instead of each including its own copy of the generic runtime code.
+ *
+ * Build it from the SWIG library directory, for example:
+ *
+ *   cc -shared -fPIC -I`swig -swiglib` `swig -swiglib`/linkruntime.c -o libswigrun.so
+ * ----------------------------------------------------------------------------- */
+
+#define SWIG_BUILD_RUNTIME
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "swiglabels.swg"
+
+#define SWIGRUNTIME SWIGEXPORT
+#define SWIGRUNTIMEINLINE SWIGINTERNINLINE
+
+#include "swigrun.swg"
+
+#ifdef __cplusplus
+extern "C" {
 #endif
 
-static void *ptr = 0;
-SWIGEXPORT void *
-SWIG_ReturnGlobalTypeList(void *t) {
- if (!ptr && !t) ptr = t;
- return ptr;
+/*
+  Registry of the module lists, by the name of the type table they share.
+  The names are built by the language modules, so each language has its own
+  lists.  The callers serialize the updates, e.g. with the Python GIL.
+*/
+typedef struct swig_linked_module {
+  char                      *name;
+  swig_module_info          *module;
+  struct swig_linked_module *next;
+} swig_linked_module;
+
+static swig_linked_module *swig_linked_modules = 0;
+
+static swig_linked_module *
+SWIG_FindLinkedModule(const char *name) {
+  swig_linked_module *iter;
+  for (iter = swig_linked_modules; iter; iter = iter->next) {
+    if (strcmp(iter->name, name) == 0)
+      return iter;
+  }
+  return 0;
 }
+
+/* Return the module list of the type table name, 0 if there is none yet */
+SWIGEXPORT swig_module_info *
+SWIG_LinkedModule(const char *name) {
+  swig_linked_module *entry = SWIG_FindLinkedModule(name);
+  return entry ? entry->module : 0;
+}
+
+/* Set the module list of the type table name, 0 to remove it */
+SWIGEXPORT void
+SWIG_SetLinkedModule(const char *name, swig_module_info *module) {
+  swig_linked_module *entry = SWIG_FindLinkedModule(name);
+  if (!entry) {
+    size_t len;
+    if (!module)
+      return;
+    entry = (swig_linked_module *) malloc(sizeof(swig_linked_module));
+    if (!entry)
+      return;
+    len = strlen(name) + 1;
+    entry->name = (char *) malloc(len);
+    if (!entry->name) {
+      free(entry);
+      return;
+    }
+    memcpy(entry->name, name, len);
+    entry->next = swig_linked_modules;
+    swig_linked_modules = entry;
+  }
+  entry->module = module;
+}
+
+#ifdef __cplusplus
+}
+#endif
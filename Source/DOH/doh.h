@@ -99,10 +99,15 @@
 #define DohStrncmp         DOH_NAMESPACE(Strncmp)
 #define DohStrstr          DOH_NAMESPACE(Strstr)
 #define DohStrchr          DOH_NAMESPACE(Strchr)
+#define DohCopyUntil       DOH_NAMESPACE(CopyUntil)
+#define DohCopyWhile       DOH_NAMESPACE(CopyWhile)
 #define DohNewFile         DOH_NAMESPACE(NewFile)
 #define DohNewFileFromFile DOH_NAMESPACE(NewFileFromFile)
 #define DohNewFileFromFd   DOH_NAMESPACE(NewFileFromFd)
 #define DohFileErrorDisplay   DOH_NAMESPACE(FileErrorDisplay)
+#define DohSetWriteIfChanged  DOH_NAMESPACE(SetWriteIfChanged)
+#define DohGetWriteIfChanged  DOH_NAMESPACE(GetWriteIfChanged)
+#define DohFileBytesWritten   DOH_NAMESPACE(FileBytesWritten)
 #define DohCopyto          DOH_NAMESPACE(Copyto)
 #define DohNewList         DOH_NAMESPACE(NewList)
 #define DohNewHash         DOH_NAMESPACE(NewHash)
@@ -284,6 +289,8 @@ extern int DohStrcmp(const DOHString_or_char *s1, const DOHString_or_char *s2);
 extern int DohStrncmp(const DOHString_or_char *s1, const DOHString_or_char *s2, int n);
 extern char *DohStrstr(const DOHString_or_char *s1, const DOHString_or_char *s2);
 extern char *DohStrchr(const DOHString_or_char *s1, int ch);
+extern int DohCopyUntil(DOH *in, const char *chars, DOH *out);
+extern int DohCopyWhile(DOH *in, const char *chars, DOH *out);
 
 /* String replacement flags */
 
@@ -309,6 +316,9 @@ extern DOHFile *DohNewFileFromFd(int fd);
 extern void DohFileErrorDisplay(DOHString * filename);
 extern int DohCopyto(DOHFile * input, DOHFile * output);
 extern void DohCloseAllOpenFiles(void);
+extern void DohSetWriteIfChanged(int enable);
+extern int DohGetWriteIfChanged(void);
+extern long DohFileBytesWritten(void);
 
 
 /* -----------------------------------------------------------------------------
@@ -426,8 +436,13 @@ extern void DohMemoryDebug(void);
 #define Strncmp            DohStrncmp
 #define Strstr             DohStrstr
 #define Strchr             DohStrchr
+#define CopyUntil          DohCopyUntil
+#define CopyWhile          DohCopyWhile
 #define Copyto             DohCopyto
 #define CloseAllOpenFiles  DohCloseAllOpenFiles
+#define SetWriteIfChanged  DohSetWriteIfChanged
+#define GetWriteIfChanged  DohGetWriteIfChanged
+#define FileBytesWritten   DohFileBytesWritten
 #define Split              DohSplit
 #define SplitLines         DohSplitLines
 #define Setmark            DohSetmark
@@ -23,8 +23,101 @@ typedef struct {
   FILE *filep;
   int fd;
   int closeondel;
+  DOHString *buffer;		/* Pending output when only writing changed files */
+  DOHString *filename;
+  char *mode;
 } DohFile;
 
+static int write_if_changed = 0;
+static long bytes_written = 0;
+
+/* -----------------------------------------------------------------------------
+ * DohSetWriteIfChanged()
+ * DohGetWriteIfChanged()
+ *
+ * When enabled, files opened for writing by DohNewFile are held in memory and
+ * only written out when closed if the content differs from the existing file.
+ * This leaves the timestamp of unchanged files alone.
+ * ----------------------------------------------------------------------------- */
+
+void DohSetWriteIfChanged(int enable) {
+  write_if_changed = enable;
+}
+
+int DohGetWriteIfChanged(void) {
+  return write_if_changed;
+}
+
+/* -----------------------------------------------------------------------------
+ * DohFileBytesWritten()
+ *
+ * Total number of bytes written to all the file objects so far.
+ * ----------------------------------------------------------------------------- */
+
+long DohFileBytesWritten(void) {
+  return bytes_written;
+}
+
+/* -----------------------------------------------------------------------------
+ * file_content_matches()
+ *
+ * Returns 1 if the file named filename exists and contains exactly the bytes
+ * in buffer. The file is read in the same (text or binary) mode as it would be
+ * written so that line ending translation does not cause false differences.
+ * ----------------------------------------------------------------------------- */
+
+static int file_content_matches(const char *filename, const char *mode, DOHString *buffer) {
+  char chunk[8192];
+  const char *data = (const char *) DohData(buffer);
+  long remaining = DohLen(buffer);
+  int matches = 1;
+  FILE *file = fopen(filename, strchr(mode, 'b') ? "rb" : "r");
+  if (!file)
+    return 0;
+  while (matches) {
+    size_t n = fread(chunk, 1, sizeof(chunk), file);
+    if (n == 0)
+      break;
+    if ((long) n > remaining || memcmp(chunk, data, n) != 0) {
+      matches = 0;
+    } else {
+      data += n;
+      remaining -= (long) n;
+    }
+  }
+  if (ferror(file) || remaining != 0)
+    matches = 0;
+  fclose(file);
+  return matches;
+}
+
+/* -----------------------------------------------------------------------------
+ * file_flush_buffer()
+ *
+ * Write out the pending output of a file opened in write-if-changed mode.
+ * ----------------------------------------------------------------------------- */
+
+static void file_flush_buffer(DohFile *f) {
+  if (!f->buffer)
+    return;
+  if (!file_content_matches(Char(f->filename), f->mode, f->buffer)) {
+    FILE *file = fopen(Char(f->filename), f->mode);
+    if (file) {
+      int len = DohLen(f->buffer);
+      if ((int) fwrite(DohData(f->buffer), 1, len, file) != len || fclose(file) != 0)
+	DohFileErrorDisplay(f->filename);
+    } else {
+      DohFileErrorDisplay(f->filename);
+    }
+  }
+  Delete(f->buffer);
+  Delete(f->filename);
+  DohFree(f->mode);
+  f->buffer = 0;
+  f->filename = 0;
+  f->mode = 0;
+}
+
 /* -----------------------------------------------------------------------------
  * open_files_list_instance
  * open_files_list_add
@@ -85,6 +178,7 @@ void DohCloseAllOpenFiles() {
 	check = fclose(f->filep);
 	assert(check == 0);
       }
+      file_flush_buffer(f);
       f->closeondel = 0;
       f->filep = 0;
     }
@@ -107,7 +201,8 @@ static void DelFile(DOH *fo) {
       close(f->fd);
     }
 #endif
-  open_files_list_remove(f);
+    file_flush_buffer(f);
+    open_files_list_remove(f);
   }
   DohFree(f);
 }
@@ -119,7 +214,9 @@ static void DelFile(DOH *fo) {
 static int File_read(DOH *fo, void *buffer, int len) {
   DohFile *f = (DohFile *) ObjData(fo);
 
-  if (f->filep) {
+  if (f->buffer) {
+    return DohRead(f->buffer, buffer, len);
+  } else if (f->filep) {
     return (int)fread(buffer, 1, len, f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -135,7 +232,10 @@ static int File_read(DOH *fo, void *buffer, int len) {
 
 static int File_write(DOH *fo, const void *buffer, int len) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  bytes_written += len;
+  if (f->buffer) {
+    return DohWrite(f->buffer, buffer, len);
+  } else if (f->filep) {
     int ret = (int) fwrite(buffer, 1, len, f->filep);
     int err = (ret != len) ? ferror(f->filep) : 0;
     return err ? -1 : ret;
@@ -153,7 +253,9 @@ static int File_write(DOH *fo, const void *buffer, int len) {
 
 static int File_seek(DOH *fo, long offset, int whence) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return DohSeek(f->buffer, offset, whence);
+  } else if (f->filep) {
     return fseek(f->filep, offset, whence);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -169,7 +271,9 @@ static int File_seek(DOH *fo, long offset, int whence) {
 
 static long File_tell(DOH *fo) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return DohTell(f->buffer);
+  } else if (f->filep) {
     return ftell(f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -185,7 +289,10 @@ static long File_tell(DOH *fo) {
 
 static int File_putc(DOH *fo, int ch) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  bytes_written++;
+  if (f->buffer) {
+    return DohPutc(ch, f->buffer);
+  } else if (f->filep) {
     return fputc(ch, f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -203,7 +310,9 @@ static int File_putc(DOH *fo, int ch) {
 
 static int File_getc(DOH *fo) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return DohGetc(f->buffer);
+  } else if (f->filep) {
     return fgetc(f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -224,7 +333,9 @@ static int File_getc(DOH *fo) {
 
 static int File_ungetc(DOH *fo, int ch) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return DohUngetc(ch, f->buffer);
+  } else if (f->filep) {
     return ungetc(ch, f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -283,14 +394,22 @@ DOH *DohNewFile(DOHString *filename, const char *mode, DOHList *newfiles) {
   FILE *file;
   char *filen;
 
+  int buffered = write_if_changed && mode[0] == 'w' && !strchr(mode, '+');
+
   filen = Char(filename);
-  file = fopen(filen, mode);
+  /* In write-if-changed mode, check the file can be written without truncating it */
+  file = fopen(filen, buffered ? "a" : mode);
   if (!file)
     return 0;
+  if (buffered) {
+    fclose(file);
+    file = 0;
+  }
 
   f = (DohFile *) DohMalloc(sizeof(DohFile));
   if (!f) {
-    fclose(file);
+    if (file)
+      fclose(file);
     return 0;
   }
   if (newfiles)
@@ -298,6 +417,9 @@ DOH *DohNewFile(DOHString *filename, const char *mode, DOHList *newfiles) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 1;
+  f->buffer = buffered ? NewStringEmpty() : 0;
+  f->filename = buffered ? NewString(filename) : 0;
+  f->mode = buffered ? strcpy((char *) DohMalloc(strlen(mode) + 1), mode) : 0;
   obj = DohObjMalloc(&DohFileType, f);
   open_files_list_add(f);
   return obj;
@@ -317,6 +439,9 @@ DOH *DohNewFileFromFile(FILE *file) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 0;
+  f->buffer = 0;
+  f->filename = 0;
+  f->mode = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -334,6 +459,9 @@ DOH *DohNewFileFromFd(int fd) {
   f->filep = 0;
   f->fd = fd;
   f->closeondel = 0;
+  f->buffer = 0;
+  f->filename = 0;
+  f->mode = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
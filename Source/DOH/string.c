@@ -423,9 +423,12 @@ static int String_write(DOH *so, const void *buffer, int len) {
     s->sp = s->len;
   newlen = s->sp + len + 1;
   if (newlen > s->maxsize) {
-    s->str = (char *) DohRealloc(s->str, newlen);
+    int newmaxsize = 2 * s->maxsize;
+    if (newlen > newmaxsize)
+      newmaxsize = newlen;
+    s->str = (char *) DohRealloc(s->str, newmaxsize);
     assert(s->str);
-    s->maxsize = newlen;
+    s->maxsize = newmaxsize;
     s->len = s->sp + len;
   }
   if ((s->sp + len) > s->len)
@@ -1273,3 +1276,90 @@ char *DohStrstr(const DOHString_or_char *s1, const DOHString_or_char *s2) {
 char *DohStrchr(const DOHString_or_char *s1, int ch) {
   return strchr(Char(s1), ch);
 }
+
+/* -----------------------------------------------------------------------------
+ * string_copy_run()
+ *
+ * Reads characters from the current position of the string in and writes them
+ * to out (if not null) while they are (accept = 1) or are not (accept = 0)
+ * in chars. Equivalent to a Getc()/Putc() loop, including the line number
+ * updates, but scans and copies the whole run at once. A NUL character always
+ * ends the run. Returns the number of characters copied.
+ * ----------------------------------------------------------------------------- */
+
+static int string_copy_run(DOH *in, const char *chars, int accept, DOH *out) {
+  String *s;
+  const char *start;
+  const char *c;
+  int n;
+  int lines = 0;
+
+  if (ObjType(in) != &DohStringType || (out && ObjType(out) != &DohStringType)) {
+    int ch;
+    n = 0;
+    while ((ch = DohGetc(in)) != EOF) {
+      if (ch == 0 || (strchr(chars, ch) ? !accept : accept)) {
+	DohUngetc(ch, in);
+	break;
+      }
+      if (out)
+	DohPutc(ch, out);
+      n++;
+    }
+    return n;
+  }
+
+  s = (String *) ObjData(in);
+  if (s->sp >= s->len)
+    return 0;
+  start = s->str + s->sp;
+  n = (int) (accept ? strspn(start, chars) : strcspn(start, chars));
+  for (c = start; (c = (const char *) memchr(c, '\n', start + n - c)); c++)
+    lines++;
+  s->sp += n;
+  s->line += lines;
+
+  if (out && n > 0) {
+    String *o = (String *) ObjData(out);
+    int newlen;
+    o->hashkey = -1;
+    if (o->sp > o->len)
+      o->sp = o->len;
+    newlen = o->sp + n + 1;
+    if (newlen > o->maxsize) {
+      int maxsize = o->maxsize * 2;
+      if (maxsize < newlen)
+	maxsize = newlen;
+      o->str = (char *) DohRealloc(o->str, maxsize);
+      assert(o->str);
+      o->maxsize = maxsize;
+    }
+    memcpy(o->str + o->sp, start, n);
+    o->sp += n;
+    if (o->sp > o->len) {
+      o->len = o->sp;
+      o->str[o->len] = 0;
+    }
+    o->line += lines;
+  }
+  return n;
+}
+
+/* -----------------------------------------------------------------------------
+ * DohCopyUntil()
+ * DohCopyWhile()
+ *
+ * Copy the run of characters at the current position of the string in to out
+ * (which may be null to just skip them), stopping at the first character that
+ * is (DohCopyUntil) or is not (DohCopyWhile) in chars, or at the end of in.
+ * These are fast equivalents of a Getc()/Putc() loop for use by scanners.
+ * Both in and out must be DOH objects, not FILE pointers.
+ * ----------------------------------------------------------------------------- */
+
+int DohCopyUntil(DOH *in, const char *chars, DOH *out) {
+  return string_copy_run(in, chars, 0, out);
+}
+
+int DohCopyWhile(DOH *in, const char *chars, DOH *out) {
+  return string_copy_run(in, chars, 1, out);
+}
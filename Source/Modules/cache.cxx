@@ -0,0 +1,340 @@
+/* -----------------------------------------------------------------------------
+ * This file is part of SWIG, which is licensed as a whole under version 3
+ * (or any later version) of the GNU General Public License. Some additional
+ * terms also apply to certain portions of SWIG. The full details of the SWIG
+ * license and copyrights can be found in the LICENSE and COPYRIGHT files
+ * included with the SWIG source code as distributed by the SWIG developers
+ * and at http://www.swig.org/legal.html.
+ *
+ * cache.cxx
+ *
+ * Output cache for the -cachedir option. After a successful run, the generated
+ * files are copied into the cache directory together with a record of every
+ * file that was read to produce them (the include graph found by the
+ * preprocessor plus any library files read by the language modules) and of
+ * every candidate file that did not exist when searching the include path.
+ * A later run with the same command line in the same directory whose
+ * dependencies all have the same content, and for which none of the missing
+ * files has since appeared, reuses the cached output and skips parsing and
+ * code generation. A missing file that appears could be found instead of a
+ * dependency further down the include path.
+ *
+ * Each entry in the cache directory is named after a hash of the command line
+ * and current directory and consists of <key>.swigcache, a text file containing:
+ *
+ *   swigcache 2
+ *   dep <size> <hash> <dependency filename>
+ *   missing <filename that failed to open>
+ *   out <index> <generated filename>
+ *
+ * and a copy of each generated file named <key>.<index>.
+ * ----------------------------------------------------------------------------- */
+
+#include "swigmod.h"
+#include <errno.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define getcwd _getcwd
+#else
+#include <unistd.h>
+#endif
+
+#define CACHE_RECORD_VERSION "swigcache 2"
+
+/* -----------------------------------------------------------------------------
+ * cache_hash()
+ *
+ * Hash a block of data into a 16 hex digit string. Two independent 32 bit
+ * hashes (FNV-1a and sdbm) are combined to keep accidental collisions unlikely.
+ * ----------------------------------------------------------------------------- */
+
+static void cache_hash_update(unsigned int hash[2], const char *data, int len) {
+  for (int i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)data[i];
+    hash[0] = (hash[0] ^ c) * 16777619U;
+    hash[1] = c + (hash[1] << 6) + (hash[1] << 16) - hash[1];
+  }
+}
+
+static String *cache_hash(unsigned int hash[2]) {
+  return NewStringf("%08x%08x", hash[0] & 0xffffffffU, hash[1] & 0xffffffffU);
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_read_file()
+ *
+ * Read the entire contents of a file in binary mode. Returns 0 if the file
+ * cannot be read.
+ * ----------------------------------------------------------------------------- */
+
+static String *cache_read_file(const_String_or_char_ptr filename) {
+  char buffer[8192];
+  FILE *f = fopen(Char(filename), "rb");
+  if (!f)
+    return 0;
+  String *content = NewStringEmpty();
+  size_t nbytes;
+  while ((nbytes = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    Write(content, buffer, (int)nbytes);
+  }
+  if (ferror(f)) {
+    Delete(content);
+    content = 0;
+  }
+  fclose(f);
+  return content;
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_file_signature()
+ *
+ * Returns "<size> <hash>" for the contents of a file or 0 if it cannot be read.
+ * ----------------------------------------------------------------------------- */
+
+static String *cache_file_signature(const_String_or_char_ptr filename) {
+  String *content = cache_read_file(filename);
+  if (!content)
+    return 0;
+  unsigned int hash[2] = { 2166136261U, 0 };
+  cache_hash_update(hash, Char(content), Len(content));
+  String *h = cache_hash(hash);
+  String *signature = NewStringf("%d %s", Len(content), h);
+  Delete(h);
+  Delete(content);
+  return signature;
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_current_directory()
+ *
+ * Returns the current working directory or 0 if it cannot be determined.
+ * ----------------------------------------------------------------------------- */
+
+static String *cache_current_directory() {
+  String *cwd = 0;
+  size_t size = 256;
+  while (!cwd) {
+    char *buffer = (char *)malloc(size);
+    if (!buffer)
+      return 0;
+    if (getcwd(buffer, (int)size) == buffer) {
+      cwd = NewString(buffer);
+    } else if (errno != ERANGE) {
+      free(buffer);
+      return 0;
+    }
+    free(buffer);
+    size *= 2;
+  }
+  return cwd;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_cache_key()
+ *
+ * Compute the name of the cache entry for this invocation of SWIG from the
+ * SWIG version, library location, all the command line arguments and the
+ * current directory, as relative filenames are found relative to it.
+ * Returns 0 if the current directory is not known, the cache is then not used.
+ * ----------------------------------------------------------------------------- */
+
+String *Swig_cache_key(int argc, char *argv[], const_String_or_char_ptr swiglib) {
+  String *cwd = cache_current_directory();
+  if (!cwd)
+    return 0;
+  unsigned int hash[2] = { 2166136261U, 0 };
+  const char *version = Swig_package_version();
+  cache_hash_update(hash, version, (int)strlen(version) + 1);
+  cache_hash_update(hash, Char(swiglib), Len(swiglib) + 1);
+  cache_hash_update(hash, Char(cwd), Len(cwd) + 1);
+  for (int i = 1; i < argc; i++) {
+    if (argv[i])
+      cache_hash_update(hash, argv[i], (int)strlen(argv[i]) + 1);
+  }
+  Delete(cwd);
+  return cache_hash(hash);
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_entry_name()
+ *
+ * Name of a file belonging to the cache entry key, <cachedir>/<key>.<suffix>
+ * ----------------------------------------------------------------------------- */
+
+static String *cache_entry_name(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, const_String_or_char_ptr suffix) {
+  String *name = NewString(cachedir);
+  const char *c = Char(name);
+  int len = Len(name);
+  if (len > 0 && c[len - 1] != SWIG_FILE_DELIMITER[0])
+    Append(name, SWIG_FILE_DELIMITER);
+  Printf(name, "%s.%s", key, suffix);
+  return name;
+}
+
+static String *cache_output_name(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, int index) {
+  String *suffix = NewStringf("%d", index);
+  String *name = cache_entry_name(cachedir, key, suffix);
+  Delete(suffix);
+  return name;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_cache_restore()
+ *
+ * Look for an up to date cache entry. If all the recorded dependencies have
+ * unchanged content and none of the recorded missing files exist, so that the
+ * same files would be found again, the cached output files are copied back, only touching
+ * those files whose content differs. The restored filenames are appended to
+ * output_files. Returns 1 if the output was restored from the cache.
+ * ----------------------------------------------------------------------------- */
+
+int Swig_cache_restore(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, List *output_files) {
+  String *record_name = cache_entry_name(cachedir, key, "swigcache");
+  String *record = cache_read_file(record_name);
+  Delete(record_name);
+  if (!record)
+    return 0;
+
+  int valid = 1;
+  List *lines = SplitLines(record);
+  List *outputs = NewList();
+  List *contents = NewList();
+  if (Len(lines) == 0 || Strcmp(Getitem(lines, 0), CACHE_RECORD_VERSION) != 0)
+    valid = 0;
+
+  for (int i = 1; valid && i < Len(lines); i++) {
+    const char *line = Char(Getitem(lines, i));
+    if (strncmp(line, "dep ", 4) == 0) {
+      // "dep <size> <hash> <filename>" - the signature is everything before the filename
+      const char *sep = strchr(line + 4, ' ');
+      const char *filename = sep ? strchr(sep + 1, ' ') : 0;
+      if (!filename) {
+	valid = 0;
+	break;
+      }
+      String *expected = NewStringWithSize(line + 4, (int)(filename - (line + 4)));
+      String *actual = cache_file_signature(filename + 1);
+      if (!actual || Strcmp(expected, actual) != 0)
+	valid = 0;
+      Delete(expected);
+      Delete(actual);
+    } else if (strncmp(line, "missing ", 8) == 0) {
+      FILE *f = fopen(line + 8, "r");
+      if (f) {
+	fclose(f);
+	valid = 0;
+      }
+    } else if (strncmp(line, "out ", 4) == 0) {
+      const char *filename = strchr(line + 4, ' ');
+      String *content = 0;
+      if (filename) {
+	String *cached = cache_output_name(cachedir, key, atoi(line + 4));
+	content = cache_read_file(cached);
+	Delete(cached);
+      }
+      if (!content) {
+	valid = 0;
+	break;
+      }
+      Append(outputs, filename + 1);
+      Append(contents, content);
+      Delete(content);
+    } else if (*line) {
+      valid = 0;
+    }
+  }
+
+  if (valid) {
+    int write_if_changed = GetWriteIfChanged();
+    SetWriteIfChanged(1);
+    for (int i = 0; i < Len(outputs); i++) {
+      String *filename = Getitem(outputs, i);
+      File *f = NewFile(filename, "wb", output_files);
+      if (!f) {
+	FileErrorDisplay(filename);
+	SWIG_exit(EXIT_FAILURE);
+      }
+      Write(f, Char(Getitem(contents, i)), Len(Getitem(contents, i)));
+      Delete(f);
+    }
+    SetWriteIfChanged(write_if_changed);
+  }
+
+  Delete(contents);
+  Delete(outputs);
+  Delete(lines);
+  Delete(record);
+  return valid;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_cache_save()
+ *
+ * Store the generated files, the signatures of the files they were generated
+ * from and the names of the files that were looked for but not found into the
+ * cache. Failure to update the cache is not an error,
+ * a warning is displayed and the cache entry is removed.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_cache_save(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, List *dependencies, List *missing, List *output_files) {
+  String *record = NewString(CACHE_RECORD_VERSION "\n");
+  String *record_name = cache_entry_name(cachedir, key, "swigcache");
+  String *failed = 0;
+
+  // Invalidate any existing entry before its output files are overwritten
+  remove(Char(record_name));
+
+  for (int i = 0; !failed && i < Len(dependencies); i++) {
+    String *filename = Getitem(dependencies, i);
+    String *signature = cache_file_signature(filename);
+    if (signature)
+      Printf(record, "dep %s %s\n", signature, filename);
+    else
+      failed = Copy(filename);
+    Delete(signature);
+  }
+
+  for (int i = 0; !failed && i < Len(missing); i++) {
+    Printf(record, "missing %s\n", Getitem(missing, i));
+  }
+
+  for (int i = 0; !failed && i < Len(output_files); i++) {
+    String *filename = Getitem(output_files, i);
+    String *content = cache_read_file(filename);
+    String *cached = cache_output_name(cachedir, key, i);
+    FILE *f = content ? fopen(Char(cached), "wb") : 0;
+    if (!content) {
+      failed = Copy(filename);
+    } else if (!f) {
+      failed = Copy(cached);
+    } else {
+      int written = fwrite(Char(content), 1, Len(content), f) == (size_t)Len(content);
+      if (fclose(f) != 0 || !written)
+	failed = Copy(cached);
+      Printf(record, "out %d %s\n", i, filename);
+    }
+    Delete(cached);
+    Delete(content);
+  }
+
+  // The record is written last so that an incomplete entry is never used
+  if (!failed) {
+    FILE *f = fopen(Char(record_name), "wb");
+    if (f) {
+      int written = fwrite(Char(record), 1, Len(record), f) == (size_t)Len(record);
+      if (fclose(f) != 0 || !written)
+	failed = Copy(record_name);
+    } else {
+      failed = Copy(record_name);
+    }
+  }
+  if (failed) {
+    Swig_warning(WARN_LANG_CACHE_UPDATE, "SWIG", 1, "Unable to update the cache in %s, error accessing %s.\n", cachedir, failed);
+    remove(Char(record_name));
+    Delete(failed);
+  }
+
+  Delete(record_name);
+  Delete(record);
+}
@@ -108,6 +108,8 @@ int Dispatcher::emit_one(Node *n) {
   if (wrn)
     Swig_warnfilter(wrn, 1);
 
+  Hash *sizes = Swig_size_begin(n);
+
   /* ============================================================
    * C/C++ parsing
    * ============================================================ */
@@ -182,6 +184,8 @@ int Dispatcher::emit_one(Node *n) {
     Swig_error(input_file, line_number, "Unrecognized parse tree node type '%s'\n", tag);
     ret = SWIG_ERROR;
   }
+  Swig_size_end(n, sizes);
+
   if (wrn)
     Swig_warnfilter(wrn, 0);
   return ret;
@@ -62,6 +62,7 @@ static const char *usage1 = (const char *) "\
 \nGeneral Options\n\
      -addextern      - Add extra extern declarations\n\
      -c++            - Enable C++ processing\n\
+     -cachedir <dir> - Reuse the output cached in <dir> if none of the input files have changed\n\
      -co <file>      - Check <file> out of the SWIG library\n\
      -copyctor       - Automatically generate copy constructors wherever possible\n\
      -cpperraswarn   - Treat the preprocessor #error statement as #warning (default)\n\
@@ -81,6 +82,7 @@ static const char *usage1 = (const char *) "\
      -debug-typemap  - Display typemap debugging information\n\
      -debug-tmsearch - Display typemap search debugging information\n\
      -debug-tmused   - Display typemaps used debugging information\n\
+     -debug-tmprofile - Display the usage count, time and code size of each typemap and fragment\n\
      -directors      - Turn on director mode for all the classes, mainly for testing\n\
      -dirprot        - Turn on wrapping of protected members for director classes (default)\n\
      -D<symbol>      - Define a symbol <symbol> (for conditional compilation)\n\
@@ -137,7 +139,10 @@ static const char *usage4 = (const char *) "\
      -oh <headfile>  - Set name of C++ output header file for directors to <headfile>\n\
      -outcurrentdir  - Set default output dir to current dir instead of input file's path\n\
      -outdir <dir>   - Set language specific files output directory to <dir>\n\
+     -outmanifest <file> - Write the list of generated files to <file>\n\
      -pcreversion    - Display PCRE version information\n\
+     -sizereport <file> - Write a JSON report of the generated code size per declaration,\n\
+                       typemap and fragment to <file>\n\
      -small          - Compile in virtual elimination and compact mode\n\
      -swiglib        - Report location of SWIG library and exit\n\
      -templatereduce - Reduce all the typedefs in templates\n\
@@ -148,6 +153,7 @@ static const char *usage4 = (const char *) "\
      -Werror         - Treat warnings as errors\n\
      -Wextra         - Adds the following additional warnings: " EXTRA_WARNINGS "\n\
      -w<list>        - Suppress/add warning messages, eg -w401,+321 - see Warnings.html\n\
+     -writeifchanged - Only write generated files whose content has changed\n\
      -xmlout <file>  - Write XML version of the parse tree to <file> after normal processing\n\
 \n\
 Options can also be defined using the SWIG_FEATURES environment variable, for example:\n\
@@ -185,6 +191,7 @@ static int no_cpp = 0;
 static String *outfile_name = 0;
 static String *outfile_name_h = 0;
 static int tm_debug = 0;
+static int tm_profile = 0;
 static int dump_symtabs = 0;
 static int dump_symbols = 0;
 static int dump_csymbols = 0;
@@ -207,6 +214,9 @@ static String *dependencies_file = 0;
 static String *dependencies_target = 0;
 static int external_runtime = 0;
 static String *external_runtime_name = 0;
+static String *outmanifest = 0;
+static String *sizereport = 0;
+static String *cachedir = 0;
 enum { STAGE1=1, STAGE2=2, STAGE3=4, STAGE4=8, STAGEOVERFLOW=16 };
 static List *libfiles = 0;
 static List *all_output_files = 0;
@@ -460,6 +470,67 @@ static void SWIG_dump_runtime() {
   SWIG_exit(EXIT_SUCCESS);
 }
 
+/* -----------------------------------------------------------------------------
+ * write_output_files_list()
+ *
+ * Write the names of all the generated files, one per line, to filename.
+ * Returns 0 if the file could not be opened.
+ * ----------------------------------------------------------------------------- */
+
+static int write_output_files_list(const_String_or_char_ptr filename) {
+  String *fname = NewString(filename);
+  File *f_outfiles = NewFile(fname, "w", 0);
+  Delete(fname);
+  if (!f_outfiles)
+    return 0;
+  for (int i = 0; i < Len(all_output_files); i++)
+    Printf(f_outfiles, "%s\n", Getitem(all_output_files, i));
+  Delete(f_outfiles);
+  return 1;
+}
+
+/* -----------------------------------------------------------------------------
+ * write_output_files_lists()
+ *
+ * Write the list of generated files for ccache-swig and -outmanifest.
+ * ----------------------------------------------------------------------------- */
+
+static void write_output_files_lists() {
+  char *outfiles = getenv("CCACHE_OUTFILES");
+  if (outfiles) {
+    if (!write_output_files_list(outfiles)) {
+      Printf(stderr, "Failed to write list of output files to the filename '%s' specified in CCACHE_OUTFILES environment variable - ", outfiles);
+      FileErrorDisplay(outfiles);
+      SWIG_exit(EXIT_FAILURE);
+    }
+  }
+  if (outmanifest) {
+    if (!write_output_files_list(outmanifest)) {
+      FileErrorDisplay(outmanifest);
+      SWIG_exit(EXIT_FAILURE);
+    }
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * cache_bypassed()
+ *
+ * The cache only holds the generated wrapper files, so it is not used when an
+ * option asks for anything else to be produced, such as preprocessed output,
+ * dependencies, a size report, xml or debug output.
+ * ----------------------------------------------------------------------------- */
+
+static bool cache_bypassed(int argc, char *argv[]) {
+  if (cpp_only || depend_only || no_cpp || depend || sizereport || dump_xml || browse || memory_debug)
+    return true;
+  for (int i = 1; i < argc; i++) {
+    if (argv[i] && ((strncmp(argv[i], "-debug", 6) == 0) || (strncmp(argv[i], "-dump", 5) == 0) ||
+		    (strcmp(argv[i], "-show_templates") == 0) || (strcmp(argv[i], "-tm_debug") == 0)))
+      return true;
+  }
+  return false;
+}
+
 static void getoptions(int argc, char *argv[]) {
   int i;
   // Get options
@@ -496,6 +567,16 @@ static void getoptions(int argc, char *argv[]) {
 	Preprocessor_define((DOH *) "__cplusplus __cplusplus", 0);
 	Swig_cparse_cplusplus(1);
 	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-cachedir") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  cachedir = NewString(argv[i + 1]);
+	  Swig_filename_correct(cachedir);
+	  Swig_mark_arg(i + 1);
+	  i++;
+	} else {
+	  Swig_arg_error();
+	}
       } else if (strcmp(argv[i], "-c++out") == 0) {
 	// Undocumented
 	Swig_cparse_cplusplusout(1);
@@ -707,6 +788,10 @@ static void getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-debug-tmused") == 0) {
 	Swig_typemap_used_debug_set();
 	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-debug-tmprofile") == 0) {
+	Swig_profile_set(1);
+	tm_profile = 1;
+	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-module") == 0) {
 	Swig_mark_arg(i);
 	if (argv[i + 1]) {
@@ -762,6 +847,30 @@ static void getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-outcurrentdir") == 0) {
 	Swig_mark_arg(i);
 	outcurrentdir = 1;
+      } else if (strcmp(argv[i], "-sizereport") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  sizereport = NewString(argv[i + 1]);
+	  Swig_filename_correct(sizereport);
+	  Swig_size_report_set(1);
+	  Swig_mark_arg(i + 1);
+	  i++;
+	} else {
+	  Swig_arg_error();
+	}
+      } else if (strcmp(argv[i], "-outmanifest") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  outmanifest = NewString(argv[i + 1]);
+	  Swig_filename_correct(outmanifest);
+	  Swig_mark_arg(i + 1);
+	  i++;
+	} else {
+	  Swig_arg_error();
+	}
+      } else if (strcmp(argv[i], "-writeifchanged") == 0) {
+	SetWriteIfChanged(1);
+	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-Wall") == 0) {
 	Swig_mark_arg(i);
 	Swig_warnall();
@@ -881,6 +990,7 @@ static void getoptions(int argc, char *argv[]) {
 
 int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
   char *c;
+  String *cache_key = 0;
 
   /* Initialize the SWIG core */
   Swig_init();
@@ -1052,6 +1162,16 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
       }
     }
   } else {
+    if (cachedir && !cache_bypassed(argc, argv)) {
+      cache_key = Swig_cache_key(argc, argv, SwigLib);
+      if (cache_key && Swig_cache_restore(cachedir, cache_key, all_output_files)) {
+	if (Verbose)
+	  Printf(stdout, "Output restored from cache %s\n", cachedir);
+	write_output_files_lists();
+	SWIG_exit(EXIT_SUCCESS);
+      }
+    }
+
     // Run the preprocessor
     if (Verbose)
       Printf(stdout, "Preprocessing...\n");
@@ -1096,8 +1216,12 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 	  Printf(fs, "\n%%include \"%s\"\n", Swig_filename_escape(Getitem(libfiles, i)));
 	}
 	Seek(fs, 0, SEEK_SET);
+	if (cpp_only)
+	  Preprocessor_output(stdout);
 	cpps = Preprocessor_parse(fs);
 	Delete(fs);
+	if (Verbose)
+	  Preprocessor_stats();
       } else {
 	cpps = Swig_read_file(df);
 	fclose(df);
@@ -1352,23 +1476,21 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
   }
   if (tm_debug)
     Swig_typemap_debug();
-  if (memory_debug)
-    DohMemoryDebug();
-
-  char *outfiles = getenv("CCACHE_OUTFILES");
-  if (outfiles) {
-    File *f_outfiles = NewFile(outfiles, "w", 0);
-    if (!f_outfiles) {
-      Printf(stderr, "Failed to write list of output files to the filename '%s' specified in CCACHE_OUTFILES environment variable - ", outfiles);
-      FileErrorDisplay(outfiles);
+  if (tm_profile)
+    Swig_profile_report();
+  if (sizereport) {
+    File *f_sizereport = NewFile(sizereport, "w", 0);
+    if (!f_sizereport) {
+      FileErrorDisplay(sizereport);
       SWIG_exit(EXIT_FAILURE);
-    } else {
-      int i;
-      for (i = 0; i < Len(all_output_files); i++)
-        Printf(f_outfiles, "%s\n", Getitem(all_output_files, i));
-      Delete(f_outfiles);
     }
+    Swig_size_report(f_sizereport);
+    Delete(f_sizereport);
   }
+  if (memory_debug)
+    DohMemoryDebug();
+
+  write_output_files_lists();
 
   // Deletes
   Delete(libfiles);
@@ -1379,12 +1501,20 @@ int SWIG_main(int argc, char *argv[], const TargetLanguageModule *tlm) {
 
   delete lang;
 
+  // Files registered by name with the file handler are not deleted, make sure any pending output is written
+  CloseAllOpenFiles();
+
   int error_count = werror ? Swig_warn_count() : 0;
   error_count += Swig_error_count();
 
   if (error_count != 0)
     SWIG_exit(error_count);
 
+  if (cache_key) {
+    Swig_cache_save(cachedir, cache_key, Swig_opened_files(), Swig_missing_files(), all_output_files);
+    Delete(cache_key);
+  }
+
   return 0;
 }
 
@@ -1398,9 +1528,9 @@ void SWIG_exit(int exit_code) {
   while (freeze) {
   }
 
-  if (exit_code > 0) {
-    CloseAllOpenFiles();
+  CloseAllOpenFiles();
 
+  if (exit_code > 0) {
     /* Remove all generated files */
     if (all_output_files) {
       for (int i = 0; i < Len(all_output_files); i++) {
@@ -360,11 +360,13 @@ List *Swig_overload_rank(Node *n, bool script_lang_wrapping) {
   return result;
 }
 
-// /* -----------------------------------------------------------------------------
-//  * print_typecheck()
-//  * ----------------------------------------------------------------------------- */
+/* -----------------------------------------------------------------------------
+ * typecheck_code()
+ *
+ * The typecheck code for argument j, or null if there is no typecheck typemap.
+ * ----------------------------------------------------------------------------- */
 
-static bool print_typecheck(String *f, int j, Parm *pj, bool implicitconvtypecheckoff) {
+static String *typecheck_code(int j, Parm *pj, bool implicitconvtypecheckoff) {
   char tmp[256];
   sprintf(tmp, Char(argv_template_string), j);
   String *tm = Getattr(pj, "tmap:typecheck");
@@ -378,11 +380,44 @@ static bool print_typecheck(String *f, int j, Parm *pj, bool implicitconvtypeche
       Replaceall(tm, "$implicitconv", "0");
     }
     Replaceall(tm, "$input", tmp);
-    Printv(f, tm, "\n", NIL);
-    Delete(tm);
-    return true;
-  } else
-    return false;
+  }
+  return tm;
+}
+
+/* -----------------------------------------------------------------------------
+ * overload_typechecks()
+ *
+ * Returns the typecheck code for each of the arguments of the overloaded
+ * method ni, an empty string for an argument without a typecheck typemap.
+ * ----------------------------------------------------------------------------- */
+
+static List *overload_typechecks(Node *n, Node *ni) {
+  List *checks = NewList();
+  Parm *pi = Getattr(ni, "wrap:parms");
+  bool implicitconvtypecheckoff = GetFlag(ni, "implicitconvtypecheckoff") != 0;
+
+  int j = 0;
+  Parm *pj = pi;
+  while (pj) {
+    if (checkAttribute(pj, "tmap:in:numinputs", "0")) {
+      pj = Getattr(pj, "tmap:in:next");
+      continue;
+    }
+    String *tm = typecheck_code(GetFlag(n, "wrap:this") ? j + 1 : j, pj, implicitconvtypecheckoff);
+    if (tm) {
+      Append(checks, tm);
+      Delete(tm);
+    } else {
+      Append(checks, "");
+    }
+    Parm *pk = Getattr(pj, "tmap:in:next");
+    if (pk)
+      pj = pk;
+    else
+      pj = nextSibling(pj);
+    j++;
+  }
+  return checks;
 }
 
 /* -----------------------------------------------------------------------------
@@ -771,13 +806,129 @@ static String *overload_dispatch_fast(Node *n, const_String_or_char_ptr fmt, int
   return f;
 }
 
+/* -----------------------------------------------------------------------------
+ * overload_dispatch_candidates()
+ *
+ * Code trying, in ranked order, each of the overloaded methods in dispatch
+ * that accept argc arguments.  If argc is -1, all the methods are tried, each
+ * guarded by a check of the argument count.  checks holds the typecheck code
+ * of each method, see overload_typechecks().  A typecheck used by more than one
+ * method is only evaluated once and its result is kept in a _tc variable.
+ * Returns 0 if no method accepts argc arguments.
+ * ----------------------------------------------------------------------------- */
+
+static String *overload_dispatch_candidates(Node *n, List *dispatch, List *checks, int argc, const_String_or_char_ptr fmt) {
+  int nfunc = Len(dispatch);
+  int i, j;
+  List *candidates = NewList();
+  List *candidate_checks = NewList();
+  Hash *check_count = NewHash();
+  bool need_v = false;
+
+  for (i = 0; i < nfunc; i++) {
+    Node *ni = Getitem(dispatch, i);
+    Parm *pi = Getattr(ni, "wrap:parms");
+    List *ci = Getitem(checks, i);
+    int num_required = emit_num_required(pi);
+    int num_arguments = emit_num_arguments(pi);
+    if (GetFlag(n, "wrap:this")) {
+      num_required++;
+      num_arguments++;
+    }
+    if (argc >= 0 && (argc < num_required || argc > num_arguments))
+      continue;
+    Append(candidates, ni);
+    Append(candidate_checks, ci);
+    for (j = 0; j < Len(ci) && (argc < 0 || j < argc); j++) {
+      String *tm = Getitem(ci, j);
+      if (Len(tm) > 0) {
+	SetInt(check_count, tm, GetInt(check_count, tm) + 1);
+	need_v = true;
+      }
+    }
+  }
+
+  String *code = 0;
+  if (Len(candidates) > 0) {
+    Hash *cached = NewHash();
+    String *body = NewString("");
+    code = NewString("");
+    if (need_v)
+      Printf(code, "int _v;\n");
+
+    for (i = 0; i < Len(candidates); i++) {
+      Node *ni = Getitem(candidates, i);
+      List *ci = Getitem(candidate_checks, i);
+      Parm *pi = Getattr(ni, "wrap:parms");
+      int num_required = emit_num_required(pi);
+      int num_arguments = emit_num_arguments(pi);
+      if (GetFlag(n, "wrap:this")) {
+	num_required++;
+	num_arguments++;
+      }
+      String *lfmt = ReplaceFormat(fmt, num_arguments);
+      int num_braces = 0;
+      if (argc >= 0)
+	Printf(body, "{\n");
+      else if (num_required == num_arguments)
+	Printf(body, "if (%s == %d) {\n", argc_template_string, num_required);
+      else
+	Printf(body, "if ((%s >= %d) && (%s <= %d)) {\n", argc_template_string, num_required, argc_template_string, num_arguments);
+      for (j = 0; j < Len(ci) && (argc < 0 || j < argc); j++) {
+	String *tm = Getitem(ci, j);
+	if (argc < 0 && j >= num_required) {
+	  Printf(body, "if (%s <= %d) {\n", argc_template_string, j);
+	  Printf(body, Char(lfmt), Getattr(ni, "wrap:name"));
+	  Printf(body, "}\n");
+	}
+	if (Len(tm) == 0)
+	  continue;
+	if (GetInt(check_count, tm) > 1) {
+	  String *tc = Getattr(cached, tm);
+	  if (!tc) {
+	    tc = NewStringf("_tc%d", Len(cached));
+	    Setattr(cached, tm, tc);
+	    Printf(code, "int %s = -1;\n", tc);
+	    Delete(tc);
+	  }
+	  Printf(body, "if (%s < 0) {\n", tc);
+	  Printv(body, tm, "\n", NIL);
+	  Printf(body, "%s = _v;\n", tc);
+	  Printf(body, "}\n");
+	  Printf(body, "_v = %s;\n", tc);
+	} else {
+	  Printv(body, tm, "\n", NIL);
+	}
+	Printf(body, "if (_v) {\n");
+	num_braces++;
+      }
+      Printf(body, Char(lfmt), Getattr(ni, "wrap:name"));
+      Printf(body, "\n");
+      Delete(lfmt);
+      /* close braces */
+      for ( /* empty */ ; num_braces > 0; num_braces--)
+	Printf(body, "}\n");
+      Printf(body, "}\n");	/* braces closes the block for this method */
+    }
+    Append(code, body);
+    Delete(body);
+    Delete(cached);
+  }
+  Delete(check_count);
+  Delete(candidate_checks);
+  Delete(candidates);
+  return code;
+}
+
 String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxargs, const_String_or_char_ptr fmt_fastdispatch) {
 
   if (fast_dispatch_mode || GetFlag(n, "feature:fastdispatch")) {
     return overload_dispatch_fast(n, fmt, maxargs, fmt_fastdispatch);
   }
 
-  int i, j;
+  int i, j, argc;
+  int max_arguments = 0;
+  bool default_arguments = false;
 
   *maxargs = 1;
 
@@ -786,13 +937,11 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
   /* Get a list of methods ranked by precedence values and argument count */
   List *dispatch = Swig_overload_rank(n, true);
   int nfunc = Len(dispatch);
-
-  /* Loop over the functions */
+  List *checks = NewList();
 
   for (i = 0; i < nfunc; i++) {
     Node *ni = Getitem(dispatch, i);
     Parm *pi = Getattr(ni, "wrap:parms");
-    bool implicitconvtypecheckoff = GetFlag(ni, "implicitconvtypecheckoff") != 0;
     int num_required = emit_num_required(pi);
     int num_arguments = emit_num_arguments(pi);
     if (GetFlag(n, "wrap:this")) {
@@ -801,18 +950,11 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
     }
     if (num_arguments > *maxargs)
       *maxargs = num_arguments;
+    if (num_arguments > max_arguments)
+      max_arguments = num_arguments;
+    if (num_required != num_arguments)
+      default_arguments = true;
 
-    if (num_required == num_arguments) {
-      Printf(f, "if (%s == %d) {\n", argc_template_string, num_required);
-    } else {
-      Printf(f, "if ((%s >= %d) && (%s <= %d)) {\n", argc_template_string, num_required, argc_template_string, num_arguments);
-    }
-
-    if (num_arguments) {
-      Printf(f, "int _v;\n");
-    }
-
-    int num_braces = 0;
     j = 0;
     Parm *pj = pi;
     while (pj) {
@@ -820,17 +962,6 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
 	pj = Getattr(pj, "tmap:in:next");
 	continue;
       }
-      if (j >= num_required) {
-	String *lfmt = ReplaceFormat(fmt, num_arguments);
-	Printf(f, "if (%s <= %d) {\n", argc_template_string, j);
-	Printf(f, Char(lfmt), Getattr(ni, "wrap:name"));
-	Printf(f, "}\n");
-	Delete(lfmt);
-      }
-      if (print_typecheck(f, (GetFlag(n, "wrap:this") ? j + 1 : j), pj, implicitconvtypecheckoff)) {
-	Printf(f, "if (_v) {\n");
-	num_braces++;
-      }
       if (!Getattr(pj, "tmap:in:SWIGTYPE") && Getattr(pj, "tmap:typecheck:SWIGTYPE")) {
 	/* we emit  a warning if the argument defines the 'in' typemap, but not the 'typecheck' one */
 	Swig_warning(WARN_TYPEMAP_TYPECHECK_UNDEF, Getfile(ni), Getline(ni),
@@ -844,16 +975,44 @@ String *Swig_overload_dispatch(Node *n, const_String_or_char_ptr fmt, int *maxar
 	pj = nextSibling(pj);
       j++;
     }
-    String *lfmt = ReplaceFormat(fmt, num_arguments);
-    Printf(f, Char(lfmt), Getattr(ni, "wrap:name"));
-    Delete(lfmt);
-    /* close braces */
-    for ( /* empty */ ; num_braces > 0; num_braces--)
-      Printf(f, "}\n");
-    Printf(f, "}\n");		/* braces closes "if" for this method */
-    if (implicitconvtypecheckoff)
+
+    /* An implicitconv method is listed twice, only the first time with the
+       implicit conversions turned off, so the flag is cleared once used */
+    List *ci = overload_typechecks(n, ni);
+    Append(checks, ci);
+    Delete(ci);
+    if (GetFlag(ni, "implicitconvtypecheckoff"))
       Delattr(ni, "implicitconvtypecheckoff");
   }
+
+  if (default_arguments) {
+    /* Methods with compact default arguments accept a range of argument
+       counts, a switch would repeat their typechecks for each count */
+    String *code = overload_dispatch_candidates(n, dispatch, checks, -1, fmt);
+    if (code) {
+      Printf(f, "{\n");
+      Printv(f, code, NIL);
+      Printf(f, "}\n");
+      Delete(code);
+    }
+  } else {
+    /* Switch on the argument count so that only the methods that take that
+       number of arguments are considered */
+    Printf(f, "switch (%s) {\n", argc_template_string);
+    for (argc = 0; argc <= max_arguments; argc++) {
+      String *code = overload_dispatch_candidates(n, dispatch, checks, argc, fmt);
+      if (code) {
+	Printf(f, "case %d: {\n", argc);
+	Printv(f, code, NIL);
+	Printf(f, "break;\n");
+	Printf(f, "}\n");
+	Delete(code);
+      }
+    }
+    Printf(f, "}\n");
+  }
+
+  Delete(checks);
   Delete(dispatch);
   return f;
 }
@@ -36,6 +36,7 @@ static int shadow = 1;
 static int use_kw = 0;
 static int director_method_index = 0;
 static int builtin = 0;
+static int sharedruntime = 0;
 
 static File *f_begin = 0;
 static File *f_runtime = 0;
@@ -128,6 +129,7 @@ static const char *usage3 = "\
      -olddefs        - Keep the old method definitions when using -fastproxy\n\
      -py3            - Generate code with Python 3 specific features and syntax\n\
      -relativeimport - Use relative Python imports\n\
+     -sharedruntime  - Link to the shared SWIG runtime library instead of including the runtime code\n\
      -threads        - Add thread support for all the interface\n\
      -O              - Enable the following optimization options:\n\
                          -fastdispatch -fastproxy -fvirtual\n\
@@ -209,6 +211,17 @@ static String *getClosure(String *functype, String *wrapper, int funpack = 0) {
   return NULL;
 }
 
+/* Whether any class, including imported classes, uses %trackobjects */
+static bool hasTrackedClass(Node *n) {
+  for (Node *c = n; c; c = nextSibling(c)) {
+    if (Equal(nodeType(c), "class") && GetFlag(c, "feature:trackobjects"))
+      return true;
+    if (hasTrackedClass(firstChild(c)))
+      return true;
+  }
+  return false;
+}
+
 class PYTHON:public Language {
 public:
   PYTHON() {
@@ -400,6 +413,9 @@ public:
 	} else if (strcmp(argv[i], "-relativeimport") == 0) {
 	  relativeimport = 1;
 	  Swig_mark_arg(i);
+	} else if (strcmp(argv[i], "-sharedruntime") == 0) {
+	  sharedruntime = 1;
+	  Swig_mark_arg(i);
 	} else if (strcmp(argv[i], "-cppcast") == 0 ||
 		   strcmp(argv[i], "-fastinit") == 0 ||
 		   strcmp(argv[i], "-fastquery") == 0 ||
@@ -611,6 +627,14 @@ public:
       Printf(f_runtime, "#define SWIGPYTHON_BUILTIN\n");
     }
 
+    if (sharedruntime) {
+      Printf(f_runtime, "#define SWIG_LINK_RUNTIME\n");
+    }
+
+    if (hasTrackedClass(n)) {
+      Printf(f_runtime, "#define SWIG_PYTHON_TRACKING\n");
+    }
+
     Printf(f_runtime, "\n");
 
     Printf(f_header, "#ifdef SWIG_TypeQuery\n");
@@ -781,6 +805,7 @@ public:
     /* the method exported for replacement of new.instancemethod in Python 3 */
     add_pyinstancemethod_new();
     add_pystaticmethod_new();
+    add_pyruntimestats();
 
     if (builtin) {
       SwigType *s = NewString("SwigPyObject");
@@ -935,6 +960,17 @@ public:
     return 0;
   }
 
+  /* ------------------------------------------------------------
+   * Emit the _swig_stats function to MethodDef array.
+   * It only exists when the wrapper is compiled with SWIG_RUNTIME_STATS.
+   * ------------------------------------------------------------ */
+  int add_pyruntimestats() {
+    Append(methods, "#ifdef SWIG_RUNTIME_STATS\n");
+    Append(methods, "\t { \"_swig_stats\", SWIG_Python_RuntimeStats, METH_NOARGS, NULL},\n");
+    Append(methods, "#endif\n");
+    return 0;
+  }
+
   /* ------------------------------------------------------------
    * subpkg_tail()
    *
@@ -2507,6 +2543,8 @@ public:
     Printf(tmp, "PyObject *argv[%d] = {0}", maxargs + 1);
     Wrapper_add_local(f, "argv", tmp);
 
+    Printf(f->code, "SWIG_STATS_CALL(\"%s\");\n", wname);
+
     if (!fastunpack) {
       Wrapper_add_local(f, "ii", "Py_ssize_t ii");
 
@@ -2723,6 +2761,7 @@ public:
     if (overname) {
       Append(wname, overname);
     }
+    Printf(f->code, "SWIG_STATS_CALL(\"%s\");\n", wname);
 
     const char *builtin_kwargs = builtin_ctor ? ", PyObject *kwargs" : "";
     if (!allow_kwargs || overname) {
@@ -4317,6 +4356,8 @@ public:
     Printv(f_init, "    Py_INCREF(builtin_pytype);\n", NIL);
     Printf(f_init, "    PyModule_AddObject(m, \"%s\", (PyObject *)builtin_pytype);\n", symname);
     Printf(f_init, "    SwigPyBuiltin_AddPublicSymbol(public_interface, \"%s\");\n", symname);
+    if (GetFlag(n, "feature:trackobjects"))
+      Printf(f_init, "    SWIG_Python_TrackType(&%s_clientdata);\n", templ);
     Printv(f_init, "    d = md;\n", NIL);
 
     Delete(clientdata);
@@ -4509,8 +4550,10 @@ public:
 	Printv(f_wrappers, "  PyObject *obj;\n", NIL);
 	Printv(f_wrappers, "  if (!SWIG_Python_UnpackTuple(args, \"swigregister\", 1, 1, &obj)) return NULL;\n", NIL);
 
-	Printv(f_wrappers,
-	       "  SWIG_TypeNewClientData(SWIGTYPE", SwigType_manglestr(ct), ", SWIG_NewClientData(obj));\n", "  return SWIG_Py_Void();\n", "}\n\n", NIL);
+	Printv(f_wrappers, "  SWIG_TypeNewClientData(SWIGTYPE", SwigType_manglestr(ct), ", SWIG_NewClientData(obj));\n", NIL);
+	if (GetFlag(n, "feature:trackobjects"))
+	  Printv(f_wrappers, "  SWIG_Python_TrackType(SWIGTYPE", SwigType_manglestr(ct), "->clientdata);\n", NIL);
+	Printv(f_wrappers, "  return SWIG_Py_Void();\n", "}\n\n", NIL);
 	String *cname = NewStringf("%s_swigregister", class_name);
 	add_method(cname, cname, 0, 0, 1, 1, 1);
 	Delete(cname);
@@ -5173,6 +5216,15 @@ public:
       Append(s, sapi);
       Delete(sapi);
     }
+    String *stracking = Swig_include_sys("swigtracking.swg");
+    if (!stracking) {
+      Printf(stderr, "*** Unable to open 'swigtracking.swg'\n");
+    } else {
+      Printf(s, "#ifdef SWIG_PYTHON_TRACKING\n");
+      Append(s, stracking);
+      Printf(s, "#endif\n");
+      Delete(stracking);
+    }
     String *srun = Swig_include_sys("pyrun.swg");
     if (!srun) {
       Printf(stderr, "*** Unable to open 'pyrun.swg'\n");
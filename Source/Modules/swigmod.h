@@ -379,6 +379,11 @@ void Swig_print_xml(Node *obj, String *filename);
 /* get the list of generated files */
 List *SWIG_output_files();
 
+/* cache.cxx */
+String *Swig_cache_key(int argc, char *argv[], const_String_or_char_ptr swiglib);
+int Swig_cache_restore(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, List *output_files);
+void Swig_cache_save(const_String_or_char_ptr cachedir, const_String_or_char_ptr key, List *dependencies, List *missing, List *output_files);
+
 void SWIG_library_directory(const char *);
 int emit_num_arguments(ParmList *);
 int emit_num_required(ParmList *);
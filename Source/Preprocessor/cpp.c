@@ -28,9 +28,17 @@ static int import_all = 0;	/* Follow all includes, but as %import statements */
 static int imported_depth = 0;	/* Depth of %imported files */
 static int single_include = 1;	/* Only include each file once */
 static Hash *included_files = 0;
+static Hash *pragma_once_files = 0;	/* Contents of the files containing #pragma once */
+static int skipped_included = 0;	/* Include statistics */
+static int skipped_guarded = 0;
+static int skipped_pragma_once = 0;
+static int expanded_template = 0;	/* Macro expansion statistics */
+static int expanded_replace = 0;
 static List *dependencies = 0;
 static Scanner *id_scan = 0;
 static int error_as_warning = 0;	/* Understand the cpp #error directive as a special #warning */
+static File *output_stream = 0;	/* Where streamed output is written */
+static int output_streaming = 0;	/* Stream the output of the next Preprocessor_parse() */
 static int expand_defined_operator = 0;
 static int macro_level = 0;
 static int macro_start_line = 0;
@@ -42,24 +50,34 @@ static const String * macro_start_file = 0;
 /* Test a character to see if it valid in an identifier (after the first letter) */
 #define isidchar(c) ((isalnum(c)) || (c == '_') || (c == '$'))
 
+/* The isspace() and isidchar() characters */
+#define SPACECHARS " \t\n\v\f\r"
+#define IDCHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$"
+
+/* Characters that need attention in Preprocessor_replace(), anything else is copied
+   straight to the output. These are the isidentifier() characters and the start
+   of strings, comments, directives and line continuations. */
+#define REPLACE_STOPCHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_$%#\"'/\\\n"
+
 static DOH *Preprocessor_replace(DOH *);
 
 /* Skip whitespace */
 static void skip_whitespace(String *s, String *out) {
-  int c;
-  while ((c = Getc(s)) != EOF) {
-    if (!isspace(c)) {
-      Ungetc(c, s);
-      break;
-    } else if (out)
-      Putc(c, out);
-  }
+  CopyWhile(s, SPACECHARS, out);
 }
 
 /* Skip to a specified character taking line breaks into account */
 static int skip_tochar(String *s, int ch, String *out) {
   int c;
-  while ((c = Getc(s)) != EOF) {
+  char stopchars[3];
+  stopchars[0] = (char) ch;
+  stopchars[1] = '\\';
+  stopchars[2] = 0;
+  for (;;) {
+    /* Copy the ordinary characters in bulk */
+    CopyUntil(s, stopchars, out);
+    if ((c = Getc(s)) == EOF)
+      break;
     if (out)
       Putc(c, out);
     if (c == ch)
@@ -75,38 +93,46 @@ static int skip_tochar(String *s, int ch, String *out) {
   return 0;
 }
 
-static void copy_location(const DOH *s1, DOH *s2) {
-  Setfile(s2, Getfile((DOH *) s1));
-  Setline(s2, Getline((DOH *) s1));
-}
-
-static String *cpp_include(const_String_or_char_ptr fn, int sysfile) {
-  String *s = sysfile ? Swig_include_sys(fn) : Swig_include(fn);
-  if (s && single_include) {
-    String *file = Getfile(s);
-    if (Getattr(included_files, file)) {
-      Delete(s);
-      return 0;
-    }
-    Setattr(included_files, file, file);
-  }
-  if (!s) {
-    if (ignore_missing) {
-      Swig_warning(WARN_PP_MISSING_FILE, Getfile(fn), Getline(fn), "Unable to find '%s'\n", fn);
+/* Skips the lines of code excluded by a false conditional that do not need the
+   attention of Preprocessor_parse(), namely those without a preprocessor directive,
+   string, character constant, comment or SWIG directive.  Called at the start of a
+   line whose first character has already been read.  Only the line breaks are put
+   in out, as that is all that is kept of excluded code.  Returns 0 if no line
+   could be skipped. */
+static int skip_excluded_lines(String *s, String *out) {
+  char *start = (char *) Char(s) + Tell(s) - 1;
+  char *p = start;
+  int lines = 0;
+  int line;
+  for (;;) {
+    char *q = p + strspn(p, " \t\v\f\r");
+    if (*q == '#')
+      break;
+    q += strcspn(q, "%\"'/\n");
+    if (*q == '\n') {
+      lines++;
+      p = q + 1;
     } else {
-      Swig_error(Getfile(fn), Getline(fn), "Unable to find '%s'\n", fn);
-    }
-  } else {
-    String *lf;
-    Seek(s, 0, SEEK_SET);
-    if (!dependencies) {
-      dependencies = NewList();
+      if (!*q)
+	p = q;
+      break;
     }
-    lf = Copy(Swig_last_file());
-    Append(dependencies, lf);
-    Delete(lf);
   }
-  return s;
+  if (p == start)
+    return 0;
+  /* Seek() does not count the line breaks like Getc() does, so set the line
+     from those skipped, leaving out the first character already read */
+  line = Getline(s) + lines - (*start == '\n');
+  (void)Seek(s, (long)(p - start) - 1, SEEK_CUR);
+  Setline(s, line);
+  while (lines--)
+    Putc('\n', out);
+  return 1;
+}
+
+static void copy_location(const DOH *s1, DOH *s2) {
+  Setfile(s2, Getfile((DOH *) s1));
+  Setline(s2, Getline((DOH *) s1));
 }
 
 static int is_digits(const String *str) {
@@ -145,6 +171,7 @@ static String *kpp_symbols = 0;
 static String *kpp_undef = 0;
 static String *kpp_value = 0;
 static String *kpp_varargs = 0;
+static String *kpp_template = 0;
 static String *kpp_error = 0;
 static String *kpp_warning = 0;
 static String *kpp_line = 0;
@@ -165,6 +192,250 @@ static String *kpp_FILE = 0;
 static String *kpp_hash_if = 0;
 static String *kpp_hash_elif = 0;
 
+/* -----------------------------------------------------------------------------
+ * skip_comments_and_space()
+ *
+ * Used by find_include_guard() to skip over whitespace and comments.
+ * ----------------------------------------------------------------------------- */
+
+static const char *skip_comments_and_space(const char *c, int *line_start) {
+  for (;;) {
+    if (*c == '\n') {
+      *line_start = 1;
+      c++;
+    } else if (isspace((int) *c)) {
+      c++;
+    } else if (c[0] == '/' && c[1] == '*') {
+      const char *end = strstr(c + 2, "*/");
+      if (!end)
+	return c + strlen(c);
+      for (; c < end; c++) {
+	if (*c == '\n')
+	  *line_start = 1;
+      }
+      c = end + 2;
+    } else if (c[0] == '/' && c[1] == '/') {
+      c = strchr(c, '\n');
+      if (!c)
+	return "";
+    } else {
+      return c;
+    }
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * find_include_guard()
+ *
+ * Looks for the multiple include optimization patterns in the contents of a
+ * file. Returns the name of the macro if everything other than whitespace and
+ * comments is within a single #ifndef NAME or #if !defined(NAME) block,
+ * otherwise 0. Sets *once if the file contains #pragma once.
+ * ----------------------------------------------------------------------------- */
+
+static String *find_include_guard(String *s, int *once) {
+  const char *c = Char(s);
+  String *guard = 0;
+  int line_start = 1;
+  int depth = 0;
+  int closed = 0;
+  int valid = 1;
+
+  *once = 0;
+  while (*(c = skip_comments_and_space(c, &line_start))) {
+    if (*c == '#' && line_start) {
+      const char *name;
+      int len;
+      c++;
+      while (*c == ' ' || *c == '\t')
+	c++;
+      name = c;
+      while (isidchar((int) *c))
+	c++;
+      len = (int) (c - name);
+      while (*c == ' ' || *c == '\t')
+	c++;
+      if ((len == 6 && strncmp(name, "ifndef", 6) == 0) || (len == 2 && strncmp(name, "if", 2) == 0)) {
+	if (depth == 0) {
+	  const char *macro;
+	  int paren = 0;
+	  if (len == 2) {
+	    /* #if !defined(NAME) or #if !defined NAME */
+	    if (*c == '!')
+	      c++;
+	    else
+	      valid = 0;
+	    while (*c == ' ' || *c == '\t')
+	      c++;
+	    if (strncmp(c, "defined", 7) == 0)
+	      c += 7;
+	    else
+	      valid = 0;
+	    while (*c == ' ' || *c == '\t')
+	      c++;
+	    if (*c == '(') {
+	      paren = 1;
+	      c++;
+	      while (*c == ' ' || *c == '\t')
+		c++;
+	    }
+	  }
+	  macro = c;
+	  while (isidchar((int) *c))
+	    c++;
+	  if (!valid || closed || guard || c == macro)
+	    valid = 0;
+	  else
+	    guard = NewStringWithSize(macro, (int) (c - macro));
+	  while (*c == ' ' || *c == '\t')
+	    c++;
+	  if (paren) {
+	    if (*c == ')')
+	      c++;
+	    else
+	      valid = 0;
+	  }
+	  while (*c == ' ' || *c == '\t')
+	    c++;
+	  if (*c && *c != '\n' && !(c[0] == '/' && (c[1] == '/' || c[1] == '*')))
+	    valid = 0;
+	}
+	depth++;
+      } else if (len == 5 && strncmp(name, "ifdef", 5) == 0) {
+	if (depth == 0)
+	  valid = 0;
+	depth++;
+      } else if (len == 5 && strncmp(name, "endif", 5) == 0) {
+	depth--;
+	if (depth == 0)
+	  closed = 1;
+	else if (depth < 0)
+	  valid = 0;
+      } else if ((len == 4 && strncmp(name, "else", 4) == 0) || (len == 4 && strncmp(name, "elif", 4) == 0)) {
+	if (depth <= 1)
+	  valid = 0;
+      } else if (len == 6 && strncmp(name, "pragma", 6) == 0 && strncmp(c, "once", 4) == 0 && !isidchar((int) c[4])) {
+	*once = 1;
+      } else if (depth == 0) {
+	valid = 0;
+      }
+      /* Skip the rest of the directive including any continuation lines */
+      while (*c && *c != '\n') {
+	if (c[0] == '\\' && c[1] == '\n')
+	  c++;
+	else if (c[0] == '/' && c[1] == '*')
+	  break;
+	c++;
+      }
+      line_start = 0;
+    } else if (depth == 0) {
+      valid = 0;
+      c++;
+      line_start = 0;
+    } else if (c[0] == '%' && c[1] == '{') {
+      /* Code block, any # in here is passed through unprocessed */
+      const char *end = strstr(c + 2, "%}");
+      c = end ? end + 2 : c + strlen(c);
+      line_start = 0;
+    } else if (*c == '\"' || *c == '\'') {
+      char quote = *c++;
+      while (*c && *c != quote && *c != '\n') {
+	if (*c == '\\' && c[1])
+	  c++;
+	c++;
+      }
+      if (*c == quote)
+	c++;
+      line_start = 0;
+    } else {
+      c++;
+      line_start = 0;
+    }
+    if (!valid && *once)
+      break;
+  }
+  if (!valid || !closed || depth != 0) {
+    Delete(guard);
+    guard = 0;
+  }
+  return guard;
+}
+
+/* -----------------------------------------------------------------------------
+ * already_included()
+ *
+ * Checks whether an included file can be skipped without preprocessing it
+ * because it has been seen before. This is either the same file, or a file
+ * whose contents are all within an include guard whose macro is defined, or
+ * a file containing #pragma once with the same contents as one already
+ * included (the same file found via a different path).  Returns 1 for the
+ * same file and 2 for a different file, which is still a dependency.
+ * ----------------------------------------------------------------------------- */
+
+static int already_included(String *s) {
+  String *file = Getfile(s);
+  String *guard;
+  int once = 0;
+
+  if (Getattr(included_files, file)) {
+    skipped_included++;
+    return 1;
+  }
+  Setattr(included_files, file, file);
+
+  if (pragma_once_files && Getattr(pragma_once_files, s)) {
+    skipped_pragma_once++;
+    return 2;
+  }
+  guard = find_include_guard(s, &once);
+  if (guard) {
+    int defined = Getattr(Getattr(cpp, kpp_symbols), guard) != 0;
+    Delete(guard);
+    if (defined) {
+      skipped_guarded++;
+      return 2;
+    }
+  }
+  if (once) {
+    String *contents = NewString(s);
+    if (!pragma_once_files)
+      pragma_once_files = NewHash();
+    Setattr(pragma_once_files, contents, file);
+    Delete(contents);
+  }
+  return 0;
+}
+
+static String *cpp_include(const_String_or_char_ptr fn, int sysfile) {
+  String *s = sysfile ? Swig_include_sys(fn) : Swig_include(fn);
+  int skip = (s && single_include) ? already_included(s) : 0;
+  if (skip == 1) {
+    Delete(s);
+    return 0;
+  }
+  if (!s) {
+    if (ignore_missing) {
+      Swig_warning(WARN_PP_MISSING_FILE, Getfile(fn), Getline(fn), "Unable to find '%s'\n", fn);
+    } else {
+      Swig_error(Getfile(fn), Getline(fn), "Unable to find '%s'\n", fn);
+    }
+  } else {
+    String *lf;
+    Seek(s, 0, SEEK_SET);
+    if (!dependencies) {
+      dependencies = NewList();
+    }
+    lf = Copy(Swig_last_file());
+    Append(dependencies, lf);
+    Delete(lf);
+    if (skip) {
+      Delete(s);
+      return 0;
+    }
+  }
+  return s;
+}
+
 void Preprocessor_init(void) {
   Hash *s;
 
@@ -190,6 +461,7 @@ void Preprocessor_init(void) {
   kpp_line = NewString("line");
   kpp_include = NewString("include");
   kpp_varargs = NewString("varargs");
+  kpp_template = NewString("template");
 
   kpp_dinclude = NewString("%include");
   kpp_dimport = NewString("%import");
@@ -239,6 +511,7 @@ void Preprocessor_delete(void) {
   Delete(kpp_line);
   Delete(kpp_include);
   Delete(kpp_varargs);
+  Delete(kpp_template);
 
   Delete(kpp_dinclude);
   Delete(kpp_dimport);
@@ -255,6 +528,7 @@ void Preprocessor_delete(void) {
 
   Delete(cpp);
   Delete(included_files);
+  Delete(pragma_once_files);
   Preprocessor_expr_delete();
   DelScanner(id_scan);
 
@@ -282,6 +556,38 @@ void Preprocessor_error_as_warning(int a) {
   error_as_warning = a;
 }
 
+/* -----------------------------------------------------------------------------
+ * Preprocessor_output()
+ *
+ * Makes the next call to Preprocessor_parse() write its output to f as it goes
+ * instead of building it up in memory.  The output of the files it includes is
+ * streamed too, the text produced by expanding macros is not.
+ * ----------------------------------------------------------------------------- */
+
+void Preprocessor_output(File *f) {
+  output_stream = f;
+  output_streaming = f ? 1 : 0;
+}
+
+/* Writes out and clears the output of a streaming Preprocessor_parse() */
+static void stream_output(String *ns) {
+  Write(output_stream, Char(ns), Len(ns));
+  Clear(ns);
+}
+
+/* -----------------------------------------------------------------------------
+ * Preprocessor_stats()
+ *
+ * Display how many included files were skipped without being preprocessed
+ * again, because the file had already been included, was protected by an
+ * include guard or contained #pragma once.
+ * ----------------------------------------------------------------------------- */
+
+void Preprocessor_stats(void) {
+  Printf(stdout, "Preprocessor include skips: %d already included, %d include guard, %d #pragma once\n", skipped_included, skipped_guarded, skipped_pragma_once);
+  Printf(stdout, "Preprocessor macro expansions with arguments: %d from template, %d by replacement\n", expanded_template, expanded_replace);
+}
+
 
 /* -----------------------------------------------------------------------------
  * Preprocessor_define()
@@ -319,6 +625,179 @@ String *Macro_vararg_name(const_String_or_char_ptr str, const_String_or_char_ptr
   return varargname;
 }
 
+/* -----------------------------------------------------------------------------
+ * Macro templates
+ *
+ * expand_macro() substitutes the arguments of a macro into its value by making
+ * a series of Replace() passes over the value for each argument.  Macros that
+ * are expanded more than once have their value compiled into a template on the
+ * second expansion: a list of literal strings and argument slots, where each
+ * slot is a two character string holding the kind of text substituted and one
+ * more than the index of the argument.  The kinds are the macro expanded argument, the argument as given, the
+ * mangled argument or the `x` quoted argument.  The template is made by running
+ * the very same Replace() passes with placeholders for the arguments, so
+ * expanding from the template gives the same result as the Replace() passes
+ * whenever no argument contains text that the passes for later arguments would
+ * have replaced too.  The "template" attribute of the macro holds the template,
+ * or "1" after the first expansion and "0" if the value has no usable template.
+ * ----------------------------------------------------------------------------- */
+
+#define TEMPLATE_MARK '\006'
+#define TEMPLATE_EXPANDED '['
+#define TEMPLATE_RAW ']'
+#define TEMPLATE_MANGLED '|'
+#define TEMPLATE_QUOTED '{'
+#define TEMPLATE_DIGITS "!%&*+,-./:;<=>?@"
+
+static String *template_placeholder(int index, char kind) {
+  char digits[16];
+  int n = 0;
+  String *placeholder = NewStringEmpty();
+  Putc(TEMPLATE_MARK, placeholder);
+  Putc(kind, placeholder);
+  do {
+    digits[n++] = TEMPLATE_DIGITS[index % 16];
+    index /= 16;
+  } while (index);
+  while (n)
+    Putc(digits[--n], placeholder);
+  Putc(TEMPLATE_MARK, placeholder);
+  return placeholder;
+}
+
+/* Identifier characters as far as Replace() is concerned */
+#define isreplaceidchar(c) (isalnum(c) || (c) == '_')
+
+/* Checks that the identifier characters at the start or end of a literal next to
+   a slot cannot form an argument name together with the text put in the slot */
+static int template_edge_ok(const char *text, int len, int end, List *margs) {
+  int n = 0, i, l = Len(margs);
+  if (end) {
+    while (n < len && isreplaceidchar((unsigned char) text[len - 1 - n]))
+      n++;
+  } else {
+    while (n < len && isreplaceidchar((unsigned char) text[n]))
+      n++;
+  }
+  if (n == 0)
+    return 1;
+  for (i = 0; i < l; i++) {
+    char *aname = Char(Getitem(margs, i));
+    int alen = (int)strlen(aname);
+    if (alen >= n) {
+      if (end ? strncmp(aname, text + len - n, n) == 0 : strncmp(aname + alen - n, text, n) == 0)
+	return 0;
+    }
+  }
+  return 1;
+}
+
+static List *macro_template(String *mvalue, List *margs) {
+  String *ns, *temp, *tempa, *literal;
+  List *tmpl;
+  char *c;
+  int i, l = Len(margs);
+
+  if (l > 250 || strchr(Char(mvalue), TEMPLATE_MARK))
+    return 0;
+
+  ns = Copy(mvalue);
+  temp = NewStringEmpty();
+  tempa = NewStringEmpty();
+  for (i = 0; i < l; i++) {
+    String *aname = Getitem(margs, i);
+    String *expanded = template_placeholder(i, TEMPLATE_EXPANDED);
+    String *raw = template_placeholder(i, TEMPLATE_RAW);
+    String *mangled = template_placeholder(i, TEMPLATE_MANGLED);
+    String *quoted = template_placeholder(i, TEMPLATE_QUOTED);
+    if (strstr(Char(ns), "\001")) {
+      Clear(temp);
+      Clear(tempa);
+      Printf(temp, "\001%s", aname);
+      Printf(tempa, "\"%s\"", raw);
+      Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+    }
+    if (strstr(Char(ns), "\002")) {
+      Clear(temp);
+      Clear(tempa);
+      Printf(temp, "\002%s", aname);
+      Append(tempa, "\002\003");
+      Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+      Clear(temp);
+      Clear(tempa);
+      Printf(temp, "%s\002", aname);
+      Append(tempa, "\003\002");
+      Replace(ns, temp, tempa, DOH_REPLACE_ID_BEGIN);
+    }
+    if (strchr(Char(ns), '`')) {
+      Clear(temp);
+      Printf(temp, "`%s`", aname);
+      Replace(ns, temp, quoted, DOH_REPLACE_ANY);
+    }
+    if (strstr(Char(ns), "\004")) {
+      Clear(temp);
+      Printf(temp, "\004%s", aname);
+      Replace(ns, temp, mangled, DOH_REPLACE_ID_END);
+    }
+    if (strstr(Char(ns), "\005")) {
+      Clear(temp);
+      Clear(tempa);
+      Printf(temp, "\005%s", aname);
+      Printf(tempa, "\"%s\"", mangled);
+      Replace(ns, temp, tempa, DOH_REPLACE_ID_END);
+    }
+    Replace(ns, aname, expanded, DOH_REPLACE_ID);
+    Replace(ns, "\003", raw, DOH_REPLACE_ANY);
+    Delete(expanded);
+    Delete(raw);
+    Delete(mangled);
+    Delete(quoted);
+  }
+  /* Split into literals and argument slots */
+  tmpl = NewList();
+  literal = NewStringEmpty();
+  c = Char(ns);
+  while (tmpl) {
+    if (*c == TEMPLATE_MARK || !*c) {
+      char *text = Char(literal);
+      int len = Len(literal);
+      if ((Len(tmpl) > 0 && ((len == 0 && *c) || !template_edge_ok(text, len, 0, margs))) || (*c && !template_edge_ok(text, len, 1, margs))) {
+	/* Text next to a slot could combine with the substituted text, so leave it to the Replace() passes */
+	Delete(tmpl);
+	tmpl = 0;
+	break;
+      }
+      Replace(literal, "\002", "", DOH_REPLACE_ANY);
+      Replace(literal, "\001", "#", DOH_REPLACE_ANY);
+      Replace(literal, "\004", "#@", DOH_REPLACE_ANY);
+      Append(tmpl, literal);
+      Delete(literal);
+      literal = NewStringEmpty();
+      if (!*c)
+	break;
+    }
+    if (*c == TEMPLATE_MARK) {
+      String *slot = NewStringEmpty();
+      int index = 0;
+      Putc(c[1], slot);
+      for (c += 2; *c != TEMPLATE_MARK; c++)
+	index = index * 16 + (int)(strchr(TEMPLATE_DIGITS, *c) - TEMPLATE_DIGITS);
+      c++;
+      Putc(index + 1, slot);
+      Append(tmpl, slot);
+      Delete(slot);
+    } else {
+      Putc(*c, literal);
+      c++;
+    }
+  }
+  Delete(literal);
+  Delete(temp);
+  Delete(tempa);
+  Delete(ns);
+  return tmpl;
+}
+
 Hash *Preprocessor_define(const_String_or_char_ptr _str, int swigmacro) {
   String *macroname = 0, *argstr = 0, *macrovalue = 0, *file = 0, *s = 0;
   Hash *macro = 0, *symbols = 0, *m1;
@@ -767,11 +1246,90 @@ static String *get_options(String *str) {
  * line_file - only used for line/file name when reporting errors
  * ----------------------------------------------------------------------------- */
 
-static String *expand_macro(String *name, List *args, String *line_file) {
+/* -----------------------------------------------------------------------------
+ * fill_template()
+ *
+ * Expands a macro from its template, see macro_template().  args are the
+ * arguments as given and repargs the macro expanded arguments.  Returns 0 if
+ * any argument contains text the Replace() passes in expand_macro() could
+ * substitute again, in which case expand_macro() has to make those passes.
+ * ----------------------------------------------------------------------------- */
+
+/* The text put in a slot for argument first is safe if it does not contain the name
+   of an argument whose Replace() passes come later */
+static int template_safe_arg(String *arg, List *margs, int first) {
+  char *c = Char(arg);
+  int i, l = Len(margs);
+  if (strpbrk(c, "\001\002\003\004\005\006"))
+    return 0;
+  for (i = first; i < l; i++) {
+    char *aname = Char(Getitem(margs, i));
+    int len = (int)strlen(aname);
+    char *m = len ? strstr(c, aname) : 0;
+    while (m) {
+      /* Identifier boundaries as used by Replace() */
+      if ((m == c || !isreplaceidchar((unsigned char) m[-1])) && !isreplaceidchar((unsigned char) m[len]))
+	return 0;
+      m = strstr(m + 1, aname);
+    }
+  }
+  return 1;
+}
+
+static String *fill_template(List *tmpl, List *margs, List *args, List *repargs) {
   String *ns;
+  int i, l = Len(args);
+
+  for (i = 0; i < l; i++) {
+    String *arg = Getitem(args, i);
+    String *reparg = Getitem(repargs, i);
+    if (!template_safe_arg(arg, margs, i) || (!Equal(reparg, arg) && !template_safe_arg(reparg, margs, i)))
+      return 0;
+  }
+
+  ns = NewStringEmpty();
+  l = Len(tmpl);
+  for (i = 0; i < l; i++) {
+    char *slot = Char(Getitem(tmpl, i));
+    if (i % 2 == 0) {
+      Append(ns, Getitem(tmpl, i));
+    } else {
+      int index = (unsigned char) slot[1] - 1;
+      String *arg = Getitem(args, index);
+      if (slot[0] == TEMPLATE_EXPANDED) {
+	Append(ns, Getitem(repargs, index));
+      } else if (slot[0] == TEMPLATE_RAW) {
+	Append(ns, arg);
+      } else if (slot[0] == TEMPLATE_QUOTED) {
+	if (*Char(arg) == '\"') {
+	  Append(ns, arg);
+	} else {
+	  Putc('"', ns);
+	  Append(ns, arg);
+	  Putc('"', ns);
+	}
+      } else {
+	String *marg = Swig_string_mangle(arg);
+	if (!template_safe_arg(marg, margs, index)) {
+	  Delete(marg);
+	  Delete(ns);
+	  return 0;
+	}
+	Append(ns, marg);
+	Delete(marg);
+      }
+    }
+  }
+  return ns;
+}
+
+static String *expand_macro(String *name, List *args, String *line_file) {
+  String *ns = 0;
   DOH *symbols, *macro, *margs, *mvalue, *temp, *tempa, *e;
-  int i, l;
+  List *tmpl, *repargs = 0;
+  int i, l = 0;
   int isvarargs = 0;
+  int filled = 0;
 
   symbols = Getattr(cpp, kpp_symbols);
   if (!symbols)
@@ -867,22 +1425,50 @@ static String *expand_macro(String *name, List *args, String *line_file) {
     return NewString(name);
   }
 
-  /* Copy the macro value */
-  ns = Copy(mvalue);
-  copy_location(mvalue, ns);
-
-  /* Tag the macro as being expanded.   This is to avoid recursion in
-     macro expansion */
+  /* Expand the arguments */
+  if (args && margs) {
+    l = Len(margs);
+    repargs = NewList();
+    for (i = 0; i < l; i++) {
+      String *reparg = Preprocessor_replace(Getitem(args, i));
+      Append(repargs, reparg);
+      Delete(reparg);
+    }
+    /* A zero length varargs argument also removes commas before it, which is left to the code below */
+    tmpl = Getattr(macro, kpp_template);
+    if (!tmpl) {
+      Setattr(macro, kpp_template, "1");
+    } else if (DohIsString(tmpl) && Equal(tmpl, "1")) {
+      tmpl = macro_template(mvalue, margs);
+      if (tmpl) {
+	Setattr(macro, kpp_template, tmpl);
+	Delete(tmpl);
+      } else {
+	Setattr(macro, kpp_template, "0");
+      }
+    }
+    if (tmpl && !DohIsString(tmpl) && !(isvarargs && Len(Getitem(args, l - 1)) == 0))
+      ns = fill_template(tmpl, margs, args, repargs);
+  }
 
   temp = NewStringEmpty();
   tempa = NewStringEmpty();
-  if (args && margs) {
-    l = Len(margs);
+  if (ns) {
+    filled = 1;
+    expanded_template++;
+  } else {
+    if (repargs)
+      expanded_replace++;
+    /* Copy the macro value */
+    ns = Copy(mvalue);
+  }
+  copy_location(mvalue, ns);
+  if (repargs && !filled) {
     for (i = 0; i < l; i++) {
       DOH *arg, *aname;
       String *reparg;
       arg = Getitem(args, i);	/* Get an argument value */
-      reparg = Preprocessor_replace(arg);
+      reparg = Getitem(repargs, i);
       aname = Getitem(margs, i);	/* Get macro argument name */
       if (strstr(Char(ns), "\001")) {
 	/* Try to replace a quoted version of the argument */
@@ -978,12 +1564,14 @@ static String *expand_macro(String *name, List *args, String *line_file) {
       /*      Replace(ns, aname, arg, DOH_REPLACE_ID); */
       Replace(ns, aname, reparg, DOH_REPLACE_ID);	/* Replace expanded args */
       Replace(ns, "\003", arg, DOH_REPLACE_ANY);	/* Replace unexpanded arg */
-      Delete(reparg);
     }
   }
-  Replace(ns, "\002", "", DOH_REPLACE_ANY);	/* Get rid of concatenation tokens */
-  Replace(ns, "\001", "#", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
-  Replace(ns, "\004", "#@", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
+  if (!filled) {
+    Replace(ns, "\002", "", DOH_REPLACE_ANY);	/* Get rid of concatenation tokens */
+    Replace(ns, "\001", "#", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
+    Replace(ns, "\004", "#@", DOH_REPLACE_ANY);	/* Put # back (non-standard C) */
+  }
+  Delete(repargs);
 
   /* Expand this macro even further */
   Setattr(macro, kpp_expanded, "1");
@@ -1039,6 +1627,7 @@ static String *expand_macro(String *name, List *args, String *line_file) {
 static DOH *Preprocessor_replace(DOH *s) {
   DOH *ns, *symbols, *m;
   int c, i, state = 0;
+  int special;
   String *id = NewStringEmpty();
 
   assert(cpp);
@@ -1086,6 +1675,7 @@ static DOH *Preprocessor_replace(DOH *s) {
 	expand_defined_operator = 0;
       } else {
 	Putc(c, ns);
+	CopyUntil(s, REPLACE_STOPCHARS, ns);
       }
       break;
     case 2:
@@ -1101,12 +1691,16 @@ static DOH *Preprocessor_replace(DOH *s) {
     case 4:			/* An identifier */
       if (isidchar(c)) {
 	Putc(c, id);
+	CopyWhile(s, IDCHARS, id);
 	state = 4;
       } else {
 	/* We found the end of a valid identifier */
 	Ungetc(c, s);
+	/* The identifiers handled specially below all start with one of these characters */
+	c = *Char(id);
+	special = (c == 'd' || c == '_' || c == '#');
 	/* See if this is the special "defined" operator */
-       	if (Equal(kpp_defined, id)) {
+	if (special && Equal(kpp_defined, id)) {
 	  if (expand_defined_operator) {
 	    int lenargs = 0;
 	    DOH *args = 0;
@@ -1156,18 +1750,18 @@ static DOH *Preprocessor_replace(DOH *s) {
 	  }
 	  state = 0;
 	  break;
-	} else if (Equal(kpp_LINE, id)) {
+	} else if (special && Equal(kpp_LINE, id)) {
 	  Printf(ns, "%d", macro_level > 0 ? macro_start_line : Getline(s));
 	  state = 0;
 	  break;
-	} else if (Equal(kpp_FILE, id)) {
+	} else if (special && Equal(kpp_FILE, id)) {
 	  String *fn = Copy(macro_level > 0 ? macro_start_file : Getfile(s));
 	  Replaceall(fn, "\\", "\\\\");
 	  Printf(ns, "\"%s\"", fn);
 	  Delete(fn);
 	  state = 0;
 	  break;
-	} else if (Equal(kpp_hash_if, id) || Equal(kpp_hash_elif, id)) {
+	} else if (special && (Equal(kpp_hash_if, id) || Equal(kpp_hash_elif, id))) {
 	  expand_defined_operator = 1;
 	  Append(ns, id);
 	  /*
@@ -1226,6 +1820,8 @@ static DOH *Preprocessor_replace(DOH *s) {
       if (c == '\n') {
 	expand_defined_operator = 0;
 	state = 0;
+      } else {
+	CopyUntil(s, "\n", ns);
       }
       break;
     case 12:
@@ -1233,6 +1829,8 @@ static DOH *Preprocessor_replace(DOH *s) {
       Putc(c, ns);
       if (c == '*')
 	state = 13;
+      else
+	CopyUntil(s, "*", ns);
       break;
     case 13:
       Putc(c, ns);
@@ -1353,7 +1951,8 @@ static void pop_imported() {
 /* -----------------------------------------------------------------------------
  * Preprocessor_parse()
  *
- * Parses the string s.  Returns a new string containing the preprocessed version.
+ * Parses the string s.  Returns a new string containing the preprocessed version,
+ * which is empty if the output has been streamed, see Preprocessor_output().
  *
  * Parsing rules :
  *       1.  Lines starting with # are C preprocessor directives
@@ -1378,6 +1977,10 @@ String *Preprocessor_parse(String *s) {
   int start_level = 0;
   int cpp_lines = 0;
   int cond_lines[256];
+  int streaming = output_streaming;
+
+  /* Included files are streamed only when the including file is */
+  output_streaming = 0;
 
   /* Blow away all carriage returns */
   Replace(s, "\015", "", DOH_REPLACE_ANY);
@@ -1397,10 +2000,15 @@ String *Preprocessor_parse(String *s) {
   while ((c = Getc(s)) != EOF) {
     switch (state) {
     case 0:			/* Initial state - in first column */
+      /* Fast path for code excluded by a false conditional */
+      if (!allow && c != '#' && skip_excluded_lines(s, chunk))
+	break;
       /* Look for C preprocessor directives.   Otherwise, go directly to state 1 */
       if (c == '#') {
 	copy_location(s, chunk);
 	add_chunk(ns, chunk, allow);
+	if (streaming)
+	  stream_output(ns);
 	cpp_lines = 1;
 	state = 40;
       } else if (isspace(c)) {
@@ -1432,6 +2040,8 @@ String *Preprocessor_parse(String *s) {
 	}
       } else if (c == '/')
 	state = 30;		/* Comment */
+      else
+	CopyUntil(s, "%\n\"'/", chunk);
       break;
 
     case 30:			/* Possibly a comment string of some sort */
@@ -1448,11 +2058,15 @@ String *Preprocessor_parse(String *s) {
       Putc(c, chunk);
       if (c == '\n')
 	state = 0;
+      else
+	CopyUntil(s, "\n", chunk);
       break;
     case 32:
       Putc(c, chunk);
       if (c == '*')
 	state = 33;
+      else
+	CopyUntil(s, "*", chunk);
       break;
     case 33:
       Putc(c, chunk);
@@ -1779,6 +2393,10 @@ String *Preprocessor_parse(String *s) {
 	      Delslice(dirname, len - 1, len); /* Kill trailing directory delimiter */
 	      Swig_push_directory(dirname);
 	    }
+	    if (streaming) {
+	      stream_output(ns);
+	      output_streaming = 1;
+	    }
 	    s2 = Preprocessor_parse(s1);
 	    addline(ns, s2, allow);
 	    Append(ns, "%endoffile");
@@ -1862,6 +2480,8 @@ String *Preprocessor_parse(String *s) {
       Putc(c, chunk);
       if (c == '%')
 	state = 106;
+      else
+	CopyUntil(s, "%", chunk);
       break;
 
     case 106:
@@ -1884,6 +2504,8 @@ String *Preprocessor_parse(String *s) {
 	state = 0;
       } else if (c == '\\') {
 	state = 108;
+      } else {
+	CopyUntil(s, "\n\\", chunk);
       }
       break;
 
@@ -1933,6 +2555,10 @@ String *Preprocessor_parse(String *s) {
 		Delslice(dirname, len - 1, len); /* Kill trailing directory delimiter */
 		Swig_push_directory(dirname);
 	      }
+	      if (streaming) {
+		stream_output(ns);
+		output_streaming = 1;
+	      }
 	      s2 = Preprocessor_parse(s1);
 	      if (dirname) {
 		Swig_pop_directory();
@@ -2079,6 +2705,8 @@ String *Preprocessor_parse(String *s) {
 
   copy_location(s, chunk);
   add_chunk(ns, chunk, allow);
+  if (streaming)
+    stream_output(ns);
 
   /*  DelScope(scp); */
   Delete(decl);
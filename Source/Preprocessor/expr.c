@@ -34,6 +34,9 @@ static int sp = 0;		/* Stack pointer       */
 static int prec[256];		/* Precedence rules    */
 static int expr_init = 0;	/* Initialization flag */
 static const char *errmsg = 0;	/* Parsing error       */
+static Hash *results = 0;	/* Values of the expressions evaluated so far */
+
+#define EXPR_RESULTS_MAX 4096	/* Most values kept in results */
 
 /* Initialize the precedence table for various operators.  Low values have higher precedence */
 static void init_precedence() {
@@ -239,6 +242,8 @@ void Preprocessor_expr_init(void) {
 
 void Preprocessor_expr_delete(void) {
   DelScanner(scan);
+  Delete(results);
+  results = 0;
 }
 
 
@@ -257,12 +262,12 @@ static int expr_token(Scanner * s) {
 }
 
 /* -----------------------------------------------------------------------------
- * Preprocessor_expr()
+ * evaluate()
  *
  * Evaluates an arithmetic expression.  Returns the result and sets an error code.
  * ----------------------------------------------------------------------------- */
 
-int Preprocessor_expr(DOH *s, int *error) {
+static int evaluate(DOH *s, int *error) {
   int token = 0;
   int op = 0;
 
@@ -441,6 +446,44 @@ extra_rparen:
   return 0;
 }
 
+/* -----------------------------------------------------------------------------
+ * Preprocessor_expr()
+ *
+ * Evaluates an arithmetic expression.  Returns the result and sets an error code.
+ * The expression has had its macros expanded already, so the value depends on
+ * its text alone and is remembered for when the same expression comes up again,
+ * as is common in headers that repeat the same checks.  Only the values of
+ * expressions evaluated without an error are kept, so errors are reported every
+ * time, and they are all forgotten once EXPR_RESULTS_MAX are kept so that the
+ * memory used stays bounded however many different expressions there are.
+ * ----------------------------------------------------------------------------- */
+
+int Preprocessor_expr(DOH *s, int *error) {
+  String *cached;
+  int value, errors;
+
+  if (!results)
+    results = NewHash();
+  cached = Getattr(results, s);
+  if (cached) {
+    *error = 0;
+    return atoi(Char(cached));
+  }
+
+  errors = Swig_error_count();
+  value = evaluate(s, error);
+  if (!*error && Swig_error_count() == errors) {
+    String *key = Copy(s);
+    if (Len(results) >= EXPR_RESULTS_MAX)
+      Clear(results);
+    cached = NewStringf("%d", value);
+    Setattr(results, key, cached);
+    Delete(cached);
+    Delete(key);
+  }
+  return value;
+}
+
 /* -----------------------------------------------------------------------------
  * Preprocessor_expr_error()
  *
@@ -117,6 +117,8 @@ void Swig_fragment_emit(Node *n) {
   if (pc)
     *pc = 0;
   while (tok) {
+    double profile_start = Swig_profile_enabled() ? Swig_profile_clock() : 0.0;
+    int emitted_bytes = 0;
     String *name = NewString(tok);
     if (mangle)
       Append(name, mangle);
@@ -152,6 +154,7 @@ void Swig_fragment_emit(Node *n) {
 	  if (debug)
 	    Printf(f, "/* begin fragment %s */\n", name);
 	  Printf(f, "%s\n", code);
+	  emitted_bytes = Len(code) + 1;
 	  if (debug)
 	    Printf(f, "/* end fragment %s */\n\n", name);
 	  Setattr(fragments, name, "ignore");
@@ -175,6 +178,8 @@ void Swig_fragment_emit(Node *n) {
 
     if (!code) {
       Swig_warning(WARN_FRAGMENT_NOT_FOUND, Getfile(n), Getline(n), "Fragment '%s' not found.\n", name);
+    } else if (Swig_profile_enabled()) {
+      Swig_profile_record("fragment", name, Swig_profile_clock() - profile_start, emitted_bytes);
     }
     tok = pc ? pc + 1 : 0;
     if (tok) {
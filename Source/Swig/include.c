@@ -19,6 +19,11 @@ static List   *directories = 0;	        /* List of include directories */
 static String *lastpath = 0;	        /* Last file that was included */
 static List   *pdirectories = 0;        /* List of pushed directories  */
 static int     dopush = 1;		/* Whether to push directories */
+static List   *opened_files = 0;        /* All the files successfully opened */
+static Hash   *opened_files_hash = 0;
+static Hash   *missing_files = 0;       /* Filenames that failed to open */
+static List   *missing_files_list = 0;
+static Hash   *file_contents = 0;       /* Contents of the files read by Swig_include() */
 static int file_debug = 0;
 
 /* This functions determine whether to push/pop dirs in the preprocessor */
@@ -95,6 +100,32 @@ String *Swig_last_file(void) {
   return lastpath;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_opened_files()
+ * 
+ * Returns the full pathnames of all the files opened so far, each file is
+ * only listed once.
+ * ----------------------------------------------------------------------------- */
+
+List *Swig_opened_files(void) {
+  if (!opened_files)
+    opened_files = NewList();
+  return opened_files;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_missing_files()
+ *
+ * Returns the names of all the candidate files that failed to open while
+ * searching for files so far, each name is only listed once.
+ * ----------------------------------------------------------------------------- */
+
+List *Swig_missing_files(void) {
+  if (!missing_files_list)
+    missing_files_list = NewList();
+  return missing_files_list;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_search_path_any() 
  * 
@@ -152,23 +183,58 @@ List *Swig_search_path() {
 
 
 /* -----------------------------------------------------------------------------
- * Swig_open()
+ * open_candidate()
  *
- * open a file, optionally looking for it in the include path.  Returns an open  
- * FILE * on success.
+ * Open one of the candidate filenames when searching for a file. Failures are
+ * remembered so that searching the same directories for the same file again
+ * does not repeatedly try to open files that do not exist. If the contents
+ * of the file have already been read by Swig_include(), *contents is set to
+ * them instead of opening the file again.
+ * ----------------------------------------------------------------------------- */
+
+static FILE *open_candidate(String *filename, String **contents) {
+  FILE *f;
+  if (contents && file_contents) {
+    *contents = Getattr(file_contents, filename);
+    if (*contents)
+      return 0;
+  }
+  if (missing_files && Getattr(missing_files, filename))
+    return 0;
+  f = fopen(Char(filename), "r");
+  if (!f) {
+    String *key = Copy(filename);
+    if (!missing_files)
+      missing_files = NewHash();
+    Setattr(missing_files, key, "1");
+    Append(Swig_missing_files(), key);
+    Delete(key);
+  }
+  return f;
+}
+
+/* -----------------------------------------------------------------------------
+ * search_file()
+ *
+ * Find a file, optionally looking for it in the include path.  Returns an open
+ * FILE * on success and sets *path to the name the file was found under. If
+ * contents is not null, it is set to the contents of the file instead if they
+ * have been read before, in which case no file is opened.
  * ----------------------------------------------------------------------------- */
 
-static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_include_path) {
+static FILE *search_file(const_String_or_char_ptr name, int sysfile, int use_include_path, String **contents, String **path) {
   FILE *f;
   String *filename;
   List *spath = 0;
   char *cname;
-  int i, ilen, nbytes;
-  char bom[3];
+  int i, ilen;
 
   if (!directories)
     directories = NewList();
   assert(directories);
+  if (contents)
+    *contents = 0;
+  *path = 0;
 
   cname = Char(name);
   filename = NewString(cname);
@@ -176,62 +242,127 @@ static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_
   if (file_debug) {
     Printf(stdout, "  Open: %s\n", filename);
   }
-  f = fopen(Char(filename), "r");
-  if (!f && use_include_path) {
+  f = open_candidate(filename, contents);
+  if (!f && !(contents && *contents) && use_include_path) {
     spath = Swig_search_path_any(sysfile);
     ilen = Len(spath);
     for (i = 0; i < ilen; i++) {
       Clear(filename);
       Printf(filename, "%s%s", Getitem(spath, i), cname);
-      f = fopen(Char(filename), "r");
-      if (f)
+      f = open_candidate(filename, contents);
+      if (f || (contents && *contents))
 	break;
     }
     Delete(spath);
   }
-  if (f) {
-    Delete(lastpath);
-    lastpath = filename;
+  if (f || (contents && *contents)) {
+    *path = filename;
+  } else {
+    Delete(filename);
+  }
+  return f;
+}
 
-    /* Skip the UTF-8 BOM if it's present */
-    nbytes = (int)fread(bom, 1, 3, f);
-    if (nbytes == 3 && bom[0] == (char)0xEF && bom[1] == (char)0xBB && bom[2] == (char)0xBF) {
-      /* skip */
-    } else {
-      fseek(f, 0, SEEK_SET);
+/* -----------------------------------------------------------------------------
+ * skip_bom()
+ *
+ * Skip the UTF-8 BOM at the start of a file if it's present.
+ * ----------------------------------------------------------------------------- */
+
+static void skip_bom(FILE *f) {
+  char bom[3];
+  size_t nbytes = fread(bom, 1, 3, f);
+  if (nbytes == 3 && bom[0] == (char)0xEF && bom[1] == (char)0xBB && bom[2] == (char)0xBF) {
+    /* skip */
+  } else {
+    fseek(f, 0, SEEK_SET);
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_open()
+ *
+ * open a file, optionally looking for it in the include path.  Returns an open  
+ * FILE * on success. If contents is not null, it is set to the contents of the
+ * file instead if they have been read before, in which case no file is opened.
+ * ----------------------------------------------------------------------------- */
+
+static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_include_path, String **contents) {
+  String *filename;
+  FILE *f = search_file(name, sysfile, use_include_path, contents, &filename);
+
+  if (filename) {
+    if (!opened_files_hash)
+      opened_files_hash = NewHash();
+    if (!Getattr(opened_files_hash, filename)) {
+      Setattr(opened_files_hash, filename, "1");
+      Append(Swig_opened_files(), filename);
     }
+    Delete(lastpath);
+    lastpath = filename;
   }
+  if (f)
+    skip_bom(f);
   return f;
 }
 
 /* Open a file - searching the include paths to find it */
 FILE *Swig_include_open(const_String_or_char_ptr name) {
-  return Swig_open_file(name, 0, 1);
+  return Swig_open_file(name, 0, 1, 0);
 }
 
 /* Open a file - does not use include paths to find it */
 FILE *Swig_open(const_String_or_char_ptr name) {
-  return Swig_open_file(name, 0, 0);
+  return Swig_open_file(name, 0, 0, 0);
 }
 
 
 
 /* -----------------------------------------------------------------------------
- * Swig_read_file()
- * 
- * Reads data from an open FILE * and returns it as a string.
+ * read_file_data()
+ *
+ * Reads the remainder of an open FILE * into a malloc'd buffer, in one go when
+ * the size of the file is known.  Returns 0 if out of memory.
  * ----------------------------------------------------------------------------- */
 
-String *Swig_read_file(FILE *f) {
-  int len;
-  char buffer[4096];
-  String *str = NewStringEmpty();
+static char *read_file_data(FILE *f, size_t *length) {
+  long start = ftell(f);
+  long size = 0;
+  size_t maxsize, len = 0, nbytes;
+  char *data;
 
-  assert(str);
-  while (fgets(buffer, 4095, f)) {
-    Append(str, buffer);
+  if (start >= 0 && fseek(f, 0, SEEK_END) == 0) {
+    size = ftell(f) - start;
+    if (fseek(f, start, SEEK_SET) != 0)
+      size = 0;
+  }
+  /* One spare byte so that a single read hits the end of a regular file */
+  maxsize = size > 0 ? (size_t)size + 1 : 4096;
+  data = (char *) malloc(maxsize);
+  while (data && (nbytes = fread(data + len, 1, maxsize - len, f)) > 0) {
+    len += nbytes;
+    if (len == maxsize) {
+      char *newdata = (char *) realloc(data, maxsize * 2);
+      if (!newdata)
+	free(data);
+      data = newdata;
+      maxsize *= 2;
+    }
   }
-  len = Len(str);
+  *length = len;
+  return data;
+}
+
+/* -----------------------------------------------------------------------------
+ * file_string()
+ *
+ * Turns the data read from a file into a string.
+ * ----------------------------------------------------------------------------- */
+
+static String *file_string(const char *data, size_t length) {
+  String *str = NewStringWithSize(data, (int)length);
+  int len = Len(str);
+  assert(str);
   /* Add a newline if not present on last line -- the preprocessor seems to 
    * rely on \n and not EOF terminating lines */
   if (len) {
@@ -243,6 +374,25 @@ String *Swig_read_file(FILE *f) {
   return str;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_read_file()
+ * 
+ * Reads data from an open FILE * and returns it as a string.
+ * ----------------------------------------------------------------------------- */
+
+String *Swig_read_file(FILE *f) {
+  size_t length;
+  char *data = read_file_data(f, &length);
+  String *str;
+  if (!data) {
+    Printf(stderr, "Out of memory reading file\n");
+    SWIG_exit(EXIT_FAILURE);
+  }
+  str = file_string(data, length);
+  free(data);
+  return str;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_include()
  *
@@ -253,12 +403,23 @@ static String *Swig_include_any(const_String_or_char_ptr name, int sysfile) {
   FILE *f;
   String *str;
   String *file;
+  String *contents;
 
-  f = Swig_open_file(name, sysfile, 1);
-  if (!f)
+  f = Swig_open_file(name, sysfile, 1, &contents);
+  if (f) {
+    str = Swig_read_file(f);
+    fclose(f);
+    /* Keep a copy as the caller is free to modify the returned string */
+    if (!file_contents)
+      file_contents = NewHash();
+    contents = Copy(str);
+    Setattr(file_contents, Swig_last_file(), contents);
+    Delete(contents);
+  } else if (contents) {
+    str = Copy(contents);
+  } else {
     return 0;
-  str = Swig_read_file(f);
-  fclose(f);
+  }
   Seek(str, 0, SEEK_SET);
   file = Copy(Swig_last_file());
   Setfile(str, file);
@@ -324,6 +485,16 @@ File *Swig_filebyname(const_String_or_char_ptr filename) {
   return Getattr(named_files, filename);
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_named_files()
+ *
+ * All the named files registered with Swig_register_filebyname(), may be null
+ * ----------------------------------------------------------------------------- */
+
+Hash *Swig_named_files(void) {
+  return named_files;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_file_extension()
  *
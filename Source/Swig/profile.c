@@ -0,0 +1,385 @@
+/* -----------------------------------------------------------------------------
+ * This file is part of SWIG, which is licensed as a whole under version 3
+ * (or any later version) of the GNU General Public License. Some additional
+ * terms also apply to certain portions of SWIG. The full details of the SWIG
+ * license and copyrights can be found in the LICENSE and COPYRIGHT files
+ * included with the SWIG source code as distributed by the SWIG developers
+ * and at http://www.swig.org/legal.html.
+ *
+ * profile.c
+ *
+ * Collects the number of uses, the cumulative generation time and the number
+ * of bytes of code generated by each typemap and fragment. Used by the
+ * -debug-tmprofile option to find the typemaps and fragments that are the most
+ * expensive or that bloat the generated code the most.
+ *
+ * Also attributes the code generated into each named file section (wrapper,
+ * init, proxy code etc) and into files written directly, to the declaration
+ * being wrapped, for the JSON report written by the -sizereport option.
+ * ----------------------------------------------------------------------------- */
+
+#include "swig.h"
+#include <time.h>
+
+typedef struct {
+  String *category;
+  String *name;
+  int count;
+  double seconds;
+  long bytes;
+} ProfileEntry;
+
+static int profile_enabled = 0;
+static Hash *profile_entries = 0;
+static int size_report_enabled = 0;
+static List *size_entries = 0;
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_set()
+ * Swig_profile_enabled()
+ *
+ * Turn on profiling and check if profiling is on.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_set(int enable) {
+  profile_enabled = enable;
+}
+
+int Swig_profile_enabled(void) {
+  return profile_enabled;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_clock()
+ *
+ * Processor time used in seconds, for measuring the time taken by a typemap.
+ * ----------------------------------------------------------------------------- */
+
+double Swig_profile_clock(void) {
+  return (double) clock() / CLOCKS_PER_SEC;
+}
+
+static void profile_entry_delete(void *ptr) {
+  ProfileEntry *entry = (ProfileEntry *) ptr;
+  Delete(entry->category);
+  Delete(entry->name);
+  free(entry);
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_record()
+ *
+ * Add one use of the typemap or fragment name taking the given time and
+ * generating the given number of bytes. The category is displayed in the
+ * report, eg "typemap" or "fragment".
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_record(const_String_or_char_ptr category, const_String_or_char_ptr name, double seconds, int bytes) {
+  ProfileEntry *entry;
+  String *key;
+  DOH *item;
+
+  if (!profile_enabled)
+    return;
+  if (!profile_entries)
+    profile_entries = NewHash();
+  key = NewStringf("%s %s", category, name);
+  item = Getattr(profile_entries, key);
+  if (item) {
+    entry = (ProfileEntry *) Data(item);
+  } else {
+    entry = (ProfileEntry *) malloc(sizeof(ProfileEntry));
+    entry->category = NewString(category);
+    entry->name = NewString(name);
+    entry->count = 0;
+    entry->seconds = 0.0;
+    entry->bytes = 0;
+    item = NewVoid(entry, profile_entry_delete);
+    Setattr(profile_entries, key, item);
+    Delete(item);
+  }
+  entry->count++;
+  entry->seconds += seconds;
+  entry->bytes += bytes;
+  Delete(key);
+}
+
+static int profile_entry_compare(const void *a, const void *b) {
+  const ProfileEntry *ea = *(const ProfileEntry *const *) a;
+  const ProfileEntry *eb = *(const ProfileEntry *const *) b;
+  if (ea->seconds != eb->seconds)
+    return ea->seconds < eb->seconds ? 1 : -1;
+  if (ea->bytes != eb->bytes)
+    return ea->bytes < eb->bytes ? 1 : -1;
+  if (ea->count != eb->count)
+    return ea->count < eb->count ? 1 : -1;
+  return Strcmp(ea->name, eb->name);
+}
+
+static int profile_entry_bytes_compare(const void *a, const void *b) {
+  const ProfileEntry *ea = *(const ProfileEntry *const *) a;
+  const ProfileEntry *eb = *(const ProfileEntry *const *) b;
+  if (ea->bytes != eb->bytes)
+    return ea->bytes < eb->bytes ? 1 : -1;
+  if (ea->count != eb->count)
+    return ea->count < eb->count ? 1 : -1;
+  return Strcmp(ea->name, eb->name);
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_profile_report()
+ *
+ * Display the collected statistics, most expensive first. Times are inclusive
+ * of any typemaps and fragments used from within a typemap or fragment.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_profile_report(void) {
+  ProfileEntry **entries;
+  Iterator ki;
+  int n = 0;
+  int i;
+  int total_count = 0;
+  long total_bytes = 0;
+
+  Printf(stdout, "---[ typemap and fragment profile ]------------------------------------------\n");
+  Printf(stdout, "%8s %10s %10s  %-8s %s\n", "Count", "Time(s)", "Bytes", "Kind", "Name");
+  if (profile_entries) {
+    entries = (ProfileEntry **) malloc(sizeof(ProfileEntry *) * Len(profile_entries));
+    for (ki = First(profile_entries); ki.key; ki = Next(ki)) {
+      entries[n++] = (ProfileEntry *) Data(ki.item);
+    }
+    qsort(entries, n, sizeof(ProfileEntry *), profile_entry_compare);
+    for (i = 0; i < n; i++) {
+      ProfileEntry *entry = entries[i];
+      Printf(stdout, "%8d %10.4f %10ld  %-8s %s\n", entry->count, entry->seconds, entry->bytes, entry->category, entry->name);
+      total_count += entry->count;
+      total_bytes += entry->bytes;
+    }
+    free(entries);
+  }
+  Printf(stdout, "%8d %10s %10ld  %-8s\n", total_count, "", total_bytes, "total");
+  Printf(stdout, "-----------------------------------------------------------------------------\n");
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_size_report_set()
+ * Swig_size_report_enabled()
+ *
+ * Turn on the generated code size report, this also turns on profiling for
+ * the typemap and fragment sizes.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_size_report_set(int enable) {
+  size_report_enabled = enable;
+  if (enable)
+    profile_enabled = 1;
+}
+
+int Swig_size_report_enabled(void) {
+  return size_report_enabled;
+}
+
+/* -----------------------------------------------------------------------------
+ * size_snapshot()
+ *
+ * Current size of each named file section plus the total written to files
+ * ("files"). A section registered under more than one name is only counted
+ * once, under its first name alphabetically. Named sections that are files
+ * are accounted for in "files".
+ * ----------------------------------------------------------------------------- */
+
+static Hash *size_snapshot(void) {
+  Hash *sizes = NewHash();
+  Hash *named = Swig_named_files();
+  if (named) {
+    Hash *seen = NewHash();
+    List *names = Keys(named);
+    Iterator ki;
+    SortList(names, 0);
+    for (ki = First(names); ki.item; ki = Next(ki)) {
+      DOH *section = Getattr(named, ki.item);
+      if (DohIsString(section)) {
+	String *address = NewStringf("%p", section);
+	if (!Getattr(seen, address)) {
+	  Setattr(seen, address, ki.item);
+	  SetInt(sizes, ki.item, Len(section));
+	}
+	Delete(address);
+      }
+    }
+    Delete(names);
+    Delete(seen);
+  }
+  SetInt(sizes, "files", (int) FileBytesWritten());
+  return sizes;
+}
+
+/* -----------------------------------------------------------------------------
+ * size_node_kind()
+ *
+ * The kind of declaration reported for node n or null if not reported
+ * ----------------------------------------------------------------------------- */
+
+static const char *size_node_kind(Node *n) {
+  String *ntype = nodeType(n);
+  if (Equal(ntype, "cdecl")) {
+    String *kind = Getattr(n, "kind");
+    if (Equal(kind, "function"))
+      return "function";
+    if (Equal(kind, "variable"))
+      return "variable";
+  } else if (Equal(ntype, "constructor") || Equal(ntype, "destructor") || Equal(ntype, "class") || Equal(ntype, "enum") || Equal(ntype, "constant")) {
+    return Char(ntype);
+  }
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_size_begin()
+ * Swig_size_end()
+ *
+ * Called either side of the code generation for a node. Swig_size_begin
+ * returns null if no statistics are wanted for the node, otherwise the
+ * returned object must be passed to Swig_size_end. The sizes recorded for a
+ * class include all the code generated for its members.
+ * ----------------------------------------------------------------------------- */
+
+Hash *Swig_size_begin(Node *n) {
+  if (!size_report_enabled || !size_node_kind(n))
+    return 0;
+  return size_snapshot();
+}
+
+void Swig_size_end(Node *n, Hash *before) {
+  Hash *after;
+  Hash *sections;
+  Hash *entry;
+  Iterator ki;
+  const char *kind;
+  String *name;
+  int total = 0;
+
+  if (!before)
+    return;
+  after = size_snapshot();
+  sections = NewHash();
+  for (ki = First(after); ki.key; ki = Next(ki)) {
+    int bytes = GetInt(after, ki.key) - GetInt(before, ki.key);
+    if (bytes > 0) {
+      SetInt(sections, ki.key, bytes);
+      total += bytes;
+    }
+  }
+
+  if (total > 0) {
+    kind = size_node_kind(n);
+    if (Equal(nodeType(n), "class") || Equal(nodeType(n), "enum") || Equal(nodeType(n), "constant"))
+      name = Swig_name_str(n);
+    else
+      name = Swig_name_decl(n);
+    entry = NewHash();
+    Setattr(entry, "kind", kind);
+    Setattr(entry, "name", name);
+    Setattr(entry, "file", Getfile(n));
+    SetInt(entry, "line", Getline(n));
+    SetInt(entry, "bytes", total);
+    Setattr(entry, "sections", sections);
+    if (!size_entries)
+      size_entries = NewList();
+    Append(size_entries, entry);
+    Delete(entry);
+    Delete(name);
+  }
+  Delete(sections);
+  Delete(after);
+  Delete(before);
+}
+
+/* -----------------------------------------------------------------------------
+ * json_string()
+ *
+ * Output s as a JSON string literal
+ * ----------------------------------------------------------------------------- */
+
+static void json_string(File *f, const_String_or_char_ptr s) {
+  const char *c = s ? Char(s) : "";
+  Putc('"', f);
+  for (; *c; c++) {
+    unsigned char ch = (unsigned char) *c;
+    if (ch == '"' || ch == '\\') {
+      Putc('\\', f);
+      Putc(ch, f);
+    } else if (ch < 0x20) {
+      Printf(f, "\\u%04x", ch);
+    } else {
+      Putc(ch, f);
+    }
+  }
+  Putc('"', f);
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_size_report()
+ *
+ * Write the JSON size report. The declarations are listed in the order they
+ * were generated, the typemaps and fragments largest first.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_size_report(File *f) {
+  ProfileEntry **entries = 0;
+  Iterator ki;
+  int n = 0;
+  int i;
+  const char *categories[] = { "typemap", "fragment" };
+  int category;
+
+  Printf(f, "{\n  \"declarations\": [");
+  for (i = 0; size_entries && i < Len(size_entries); i++) {
+    Hash *entry = Getitem(size_entries, i);
+    Hash *sections = Getattr(entry, "sections");
+    List *names = Keys(sections);
+    Iterator si;
+    int first = 1;
+    Printf(f, "%s\n    {\"kind\": ", i ? "," : "");
+    json_string(f, Getattr(entry, "kind"));
+    Printf(f, ", \"name\": ");
+    json_string(f, Getattr(entry, "name"));
+    Printf(f, ", \"file\": ");
+    json_string(f, Getattr(entry, "file"));
+    Printf(f, ", \"line\": %d, \"bytes\": %d, \"sections\": {", GetInt(entry, "line"), GetInt(entry, "bytes"));
+    SortList(names, 0);
+    for (si = First(names); si.item; si = Next(si)) {
+      Printf(f, "%s", first ? "" : ", ");
+      json_string(f, si.item);
+      Printf(f, ": %d", GetInt(sections, si.item));
+      first = 0;
+    }
+    Printf(f, "}}");
+    Delete(names);
+  }
+  Printf(f, "\n  ]");
+
+  if (profile_entries) {
+    entries = (ProfileEntry **) malloc(sizeof(ProfileEntry *) * Len(profile_entries));
+    for (ki = First(profile_entries); ki.key; ki = Next(ki)) {
+      entries[n++] = (ProfileEntry *) Data(ki.item);
+    }
+    qsort(entries, n, sizeof(ProfileEntry *), profile_entry_bytes_compare);
+  }
+  for (category = 0; category < 2; category++) {
+    int first = 1;
+    Printf(f, ",\n  \"%ss\": [", categories[category]);
+    for (i = 0; i < n; i++) {
+      ProfileEntry *entry = entries[i];
+      if (!Equal(entry->category, categories[category]))
+	continue;
+      Printf(f, "%s\n    {\"name\": ", first ? "" : ",");
+      json_string(f, entry->name);
+      Printf(f, ", \"count\": %d, \"bytes\": %ld}", entry->count, entry->bytes);
+      first = 0;
+    }
+    Printf(f, "\n  ]");
+  }
+  Printf(f, "\n}\n");
+  free(entries);
+}
@@ -231,6 +231,47 @@ static char nextchar(Scanner *s) {
   return (char)nc;
 }
 
+/* -----------------------------------------------------------------------------
+ * nextchars()
+ *
+ * Reads a run of characters from the object being scanned in one go, exactly
+ * as calling nextchar() for each of them would.  The run is made of characters
+ * in set if accept is true, otherwise of characters not in set, and ends at the
+ * end of the object at the latest.  The caller continues with nextchar().
+ * nextnchars() reads the next n characters, which must be in the object.
+ * ----------------------------------------------------------------------------- */
+
+static const char *idchars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_$";
+
+static void nextnchars(Scanner *s, int n) {
+  char *start = Char(s->str) + Tell(s->str);
+  char *c;
+  int lines = 0;
+  int line;
+  if (n == 0)
+    return;
+  for (c = start; c < start + n; c++) {
+    if (*c == '\n')
+      lines++;
+  }
+  if (!s->freeze_line)
+    s->line += lines;
+  Write(s->text, start, n);
+  /* Seek() does not count the line breaks like Getc() does, so set the line
+     of the object from those read */
+  line = Getline(s->str) + lines;
+  (void)Seek(s->str, n, SEEK_CUR);
+  Setline(s->str, line);
+}
+
+static void nextchars(Scanner *s, const char *set, int accept) {
+  char *start;
+  if (!s->str)
+    return;
+  start = Char(s->str) + Tell(s->str);
+  nextnchars(s, (int)(accept ? strspn(start, set) : strcspn(start, set)));
+}
+
 /* -----------------------------------------------------------------------------
  * set_error() 
  *
@@ -522,6 +563,7 @@ static int look(Scanner *s) {
   while (1) {
     switch (state) {
     case 0:
+      nextchars(s, " \t", 1);
       if ((c = nextchar(s)) == 0)
 	return (0);
 
@@ -666,6 +708,7 @@ static int look(Scanner *s) {
       }
       break;
     case 10:			/* C++ style comment */
+      nextchars(s, "\n", 0);
       if ((c = nextchar(s)) == 0) {
 	Swig_error(cparse_file, cparse_start_line, "Unterminated comment\n");
 	return SWIG_TOKEN_ERROR;
@@ -678,6 +721,7 @@ static int look(Scanner *s) {
       }
       break;
     case 11:			/* C style comment block */
+      nextchars(s, "*", 0);
       if ((c = nextchar(s)) == 0) {
 	Swig_error(cparse_file, cparse_start_line, "Unterminated comment\n");
 	return SWIG_TOKEN_ERROR;
@@ -724,6 +768,7 @@ static int look(Scanner *s) {
       break;
 
     case 20:			/* Inside the string */
+      nextchars(s, str_delimiter ? ")" : "\"\\", 0);
       if ((c = nextchar(s)) == 0) {
 	Swig_error(cparse_file, cparse_start_line, "Unterminated string\n");
 	return SWIG_TOKEN_ERROR;
@@ -841,6 +886,7 @@ static int look(Scanner *s) {
       break;
 
     case 40:			/* Process an include block */
+      nextchars(s, "%", 0);
       if ((c = nextchar(s)) == 0) {
 	Swig_error(cparse_file, cparse_start_line, "Unterminated block\n");
 	return SWIG_TOKEN_ERROR;
@@ -955,6 +1001,7 @@ static int look(Scanner *s) {
       break;
 
     case 70:			/* Identifier */
+      nextchars(s, idchars, 1);
       if ((c = nextchar(s)) == 0)
 	state = 76;
       else if (isalnum(c) || (c == '_') || (c == '$')) {
@@ -1506,6 +1553,46 @@ void Scanner_skip_line(Scanner *s) {
   return;
 }
 
+/* -----------------------------------------------------------------------------
+ * skip_raw_string()
+ *
+ * Called by the balanced skipping functions just after reading a '"'.  If the
+ * quote starts a C++11 raw string literal, reads the rest of the literal and
+ * returns 1.  Returns 0, having read nothing more, for other strings and for
+ * raw strings not terminated in the object being scanned.
+ * ----------------------------------------------------------------------------- */
+
+static int skip_raw_string(Scanner *s) {
+  char *text = Char(s->text);
+  int len = Len(s->text) - 1;
+  char *start, *c, *end;
+  String *terminator;
+  /* Look for an R, u8R, uR, UR or LR prefix before the quote */
+  if (len < 1 || text[len - 1] != 'R')
+    return 0;
+  len--;
+  if (len >= 2 && text[len - 2] == 'u' && text[len - 1] == '8')
+    len -= 2;
+  else if (len >= 1 && (text[len - 1] == 'u' || text[len - 1] == 'U' || text[len - 1] == 'L'))
+    len--;
+  if (len >= 1 && (isalnum((unsigned char) text[len - 1]) || text[len - 1] == '_' || text[len - 1] == '$'))
+    return 0;
+
+  start = Char(s->str) + Tell(s->str);
+  for (c = start; *c && *c != '(' && c - start <= 16; c++) {
+    if (*c == ')' || *c == '\\' || isspace((unsigned char) *c))
+      return 0;
+  }
+  if (*c != '(')
+    return 0;
+  terminator = NewStringf(")%.*s\"", (int)(c - start), start);
+  end = strstr(c, Char(terminator));
+  if (end)
+    nextnchars(s, (int)(end - start) + Len(terminator));
+  Delete(terminator);
+  return end ? 1 : 0;
+}
+
 /* -----------------------------------------------------------------------------
  * Scanner_skip_balanced()
  *
@@ -1518,14 +1605,28 @@ int Scanner_skip_balanced(Scanner *s, int startchar, int endchar) {
   int num_levels = 1;
   int state = 0;
   char temp[2] = { 0, 0 };
+  char stopset[6] = { 0, 0, '/', '\"', '\'', 0 };
   String *locator = 0;
   temp[0] = (char) startchar;
+  stopset[0] = (char) startchar;
+  stopset[1] = (char) endchar;
   Clear(s->text);
   Setfile(s->text, Getfile(s->str));
   Setline(s->text, s->line);
 
   Append(s->text, temp);
   while (num_levels > 0) {
+    /* Read runs of characters that cannot change the state in one go */
+    if (state == 0)
+      nextchars(s, stopset, 0);
+    else if (state == 11)
+      nextchars(s, "\n", 0);
+    else if (state == 13)
+      nextchars(s, "*", 0);
+    else if (state == 20)
+      nextchars(s, "\"\\", 0);
+    else if (state == 30)
+      nextchars(s, "'\\", 0);
     if ((c = nextchar(s)) == 0) {
       Delete(locator);
       return -1;
@@ -1538,9 +1639,10 @@ int Scanner_skip_balanced(Scanner *s, int startchar, int endchar) {
 	num_levels--;
       else if (c == '/')
 	state = 10;
-      else if (c == '\"')
-	state = 20;
-      else if (c == '\'')
+      else if (c == '\"') {
+	if (!skip_raw_string(s))
+	  state = 20;
+      } else if (c == '\'')
 	state = 30;
       break;
     case 10:
@@ -1655,12 +1757,26 @@ String *Scanner_get_raw_text_balanced(Scanner *s, int startchar, int endchar) {
   int num_levels = 1;
   int state = 0;
   char temp[2] = { 0, 0 };
+  char stopset[6] = { 0, 0, '/', '\"', '\'', 0 };
   temp[0] = (char) startchar;
+  stopset[0] = (char) startchar;
+  stopset[1] = (char) endchar;
   Clear(s->text);
   Setfile(s->text, Getfile(s->str));
   Setline(s->text, s->line);
   Append(s->text, temp);
   while (num_levels > 0) {
+    /* Read runs of characters that cannot change the state in one go */
+    if (state == 0)
+      nextchars(s, stopset, 0);
+    else if (state == 11)
+      nextchars(s, "\n", 0);
+    else if (state == 13)
+      nextchars(s, "*", 0);
+    else if (state == 20)
+      nextchars(s, "\"\\", 0);
+    else if (state == 30)
+      nextchars(s, "'\\", 0);
     if ((c = nextchar(s)) == 0) {
       Clear(s->text);
       Append(s->text, old_text);
@@ -1676,9 +1792,10 @@ String *Scanner_get_raw_text_balanced(Scanner *s, int startchar, int endchar) {
 	num_levels--;
       else if (c == '/')
 	state = 10;
-      else if (c == '\"')
-	state = 20;
-      else if (c == '\'')
+      else if (c == '\"') {
+	if (!skip_raw_string(s))
+	  state = 20;
+      } else if (c == '\'')
 	state = 30;
       break;
     case 10:
@@ -421,6 +421,19 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_fragment_emit(String *name);
   extern void Swig_fragment_clear(String *section);
 
+/* --- Typemap and fragment profiling --- */
+
+  extern void Swig_profile_set(int enable);
+  extern int Swig_profile_enabled(void);
+  extern double Swig_profile_clock(void);
+  extern void Swig_profile_record(const_String_or_char_ptr category, const_String_or_char_ptr name, double seconds, int bytes);
+  extern void Swig_profile_report(void);
+  extern void Swig_size_report_set(int enable);
+  extern int Swig_size_report_enabled(void);
+  extern Hash *Swig_size_begin(Node *n);
+  extern void Swig_size_end(Node *n, Hash *before);
+  extern void Swig_size_report(File *f);
+
 /* --- Extension support --- */
 
   extern Hash *Swig_extend_hash(void);
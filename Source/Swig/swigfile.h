@@ -15,6 +15,8 @@ extern List   *Swig_add_directory(const_String_or_char_ptr dirname);
 extern void    Swig_push_directory(const_String_or_char_ptr dirname);
 extern void    Swig_pop_directory(void);
 extern String *Swig_last_file(void);
+extern List   *Swig_opened_files(void);
+extern List   *Swig_missing_files(void);
 extern List   *Swig_search_path(void);
 extern FILE   *Swig_include_open(const_String_or_char_ptr name);
 extern FILE   *Swig_open(const_String_or_char_ptr name);
@@ -26,6 +28,7 @@ extern void    Swig_set_push_dir(int dopush);
 extern int     Swig_get_push_dir(void);
 extern void    Swig_register_filebyname(const_String_or_char_ptr filename, File *outfile);
 extern File   *Swig_filebyname(const_String_or_char_ptr filename);
+extern Hash   *Swig_named_files(void);
 extern String *Swig_file_extension(const_String_or_char_ptr filename);
 extern String *Swig_file_basename(const_String_or_char_ptr filename);
 extern String *Swig_file_filename(const_String_or_char_ptr filename);
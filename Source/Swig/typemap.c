@@ -26,6 +26,14 @@ static int in_typemap_search_multi = 0;
 
 static void replace_embedded_typemap(String *s, ParmList *parm_sublist, Wrapper *f, Node *file_line_node);
 
+/* Record the cost of using a typemap for -debug-tmprofile */
+static void typemap_profile_record(Hash *tm, double start, String *code) {
+  String *tmcode = Getattr(tm, "code");
+  String *name = NewStringf("%%%s [%s:%d]", Getattr(tm, "source"), Getfile(tmcode), Getline(tmcode));
+  Swig_profile_record("typemap", name, Swig_profile_clock() - start, Len(code));
+  Delete(name);
+}
+
 /* -----------------------------------------------------------------------------
  * Typemaps are stored in a collection of nested hash tables.  Something like
  * this:
@@ -1302,6 +1310,7 @@ static String *Swig_typemap_lookup_impl(const_String_or_char_ptr tmap_method, No
   int delete_optimal_attribute = 0;
   int num_substitutions = 0;
   SwigType *matchtype = 0;
+  double profile_start = Swig_profile_enabled() ? Swig_profile_clock() : 0.0;
 
   type = Getattr(node, "type");
   if (!type)
@@ -1549,6 +1558,8 @@ static String *Swig_typemap_lookup_impl(const_String_or_char_ptr tmap_method, No
     s = p;
   }
   Delete(actioncode);
+  if (Swig_profile_enabled())
+    typemap_profile_record(tm, profile_start, s);
   return s;
 }
 
@@ -1685,6 +1696,7 @@ void Swig_typemap_attach_parms(const_String_or_char_ptr tmap_method, ParmList *p
 #endif
 
   while (p) {
+    double profile_start = Swig_profile_enabled() ? Swig_profile_clock() : 0.0;
     argnum++;
     nmatch = 0;
 #ifdef SWIG_DEBUG
@@ -1841,6 +1853,8 @@ void Swig_typemap_attach_parms(const_String_or_char_ptr tmap_method, ParmList *p
 
     /* increase argnum to consider numinputs */
     argnum += nmatch - 1;
+    if (Swig_profile_enabled())
+      typemap_profile_record(tm, profile_start, s);
     Delete(s);
 #ifdef SWIG_DEBUG
     Printf(stdout, "res: %s %s %s\n", Getattr(firstp, "name"), typemap_method_name(tmap_method), Getattr(firstp, typemap_method_name(tmap_method)));
@@ -2108,7 +2108,8 @@ List *SwigType_get_sorted_mangled_list() {
 
 void SwigType_emit_type_table(File *f_forward, File *f_table) {
   Iterator ki;
-  String *types, *table, *cast, *cast_init, *cast_temp;
+  String *types, *table, *cast, *cast_init;
+  Hash *type_data, *cast_data;
   Hash *imported_types;
   List *mangled_list;
   List *table_list = NewList();
@@ -2148,6 +2149,8 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
   types = NewStringEmpty();
   cast = NewStringEmpty();
   cast_init = NewStringEmpty();
+  type_data = NewHash();
+  cast_data = NewHash();
   imported_types = NewHash();
 
   Printf(table, "static swig_type_info *swig_type_initial[] = {\n");
@@ -2168,12 +2171,9 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
     Hash *lthash;
     Iterator ltiter;
     Hash *nthash;
+    List *cast_list = NewList();
 
-    cast_temp = NewStringEmpty();
-
-    Printv(types, "static swig_type_info _swigt_", ki.item, " = {", NIL);
     Append(table_list, ki.item);
-    Printf(cast_temp, "static swig_cast_info _swigc_%s[] = {", ki.item);
     i++;
 
     cd = SwigType_clientdata_collect(ki.item);
@@ -2222,7 +2222,8 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
     }
     Delete(nthash);
 
-    Printf(types, "\"%s\", \"%s\", 0, 0, (void*)%s, 0};\n", ki.item, nt, cd);
+    Setattr(type_data, ki.item, NewStringf("{\"%s\", \"%s\", 0, 0, (void*)%s, 0}", ki.item, nt, cd));
+    Setattr(cast_data, ki.item, cast_list);
 
     el = SwigType_equivalent_mangle(ki.item, 0, 0);
     for (ei = First(el); ei.item; ei = Next(ei)) {
@@ -2231,31 +2232,61 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
       ckey = NewStringf("%s+%s", ei.item, ki.item);
       conv = Getattr(conversions, ckey);
       if (conv) {
-	Printf(cast_temp, "  {&_swigt_%s, %s, 0, 0},", ei.item, conv);
+	Append(cast_list, NewStringf("{&_swigt_%s, %s, 0, 0}", ei.item, conv));
       } else {
-	Printf(cast_temp, "  {&_swigt_%s, 0, 0, 0},", ei.item);
+	Append(cast_list, NewStringf("{&_swigt_%s, 0, 0, 0}", ei.item));
       }
       Delete(ckey);
 
       if (!Getattr(r_mangled, ei.item) && !Getattr(imported_types, ei.item)) {
-	Printf(types, "static swig_type_info _swigt_%s = {\"%s\", 0, 0, 0, 0, 0};\n", ei.item, ei.item);
+	List *imported_cast = NewList();
+	Setattr(type_data, ei.item, NewStringf("{\"%s\", 0, 0, 0, 0, 0}", ei.item));
 	Append(table_list, ei.item);
 
-	Printf(cast, "static swig_cast_info _swigc_%s[] = {{&_swigt_%s, 0, 0, 0},{0, 0, 0, 0}};\n", ei.item, ei.item);
+	Append(imported_cast, NewStringf("{&_swigt_%s, 0, 0, 0}", ei.item));
+	Setattr(cast_data, ei.item, imported_cast);
+	Delete(imported_cast);
 	i++;
 
 	Setattr(imported_types, ei.item, "1");
       }
     }
     Delete(el);
-    Printf(cast, "%s{0, 0, 0, 0}};\n", cast_temp);
-    Delete(cast_temp);
+    Delete(cast_list);
     Delete(nt);
     Delete(rt);
   }
-  /* print the tables in the proper order */
+  /* print the tables in the proper order, the type and cast structures are
+     laid out contiguously in this order so that lookups, which binary search
+     the sorted types, touch as little memory as possible */
   SortList(table_list, SwigType_compare_mangled);
   i = 0;
+  if (Len(table_list) > 0) {
+    int ci = 0;
+    String *type_names = NewStringEmpty();
+    String *cast_names = NewStringEmpty();
+    Printf(types, "static swig_type_info swig_type_data[] = {\n");
+    Printf(cast, "static swig_cast_info swig_cast_data[] = {\n");
+    for (ki = First(table_list); ki.item; ki = Next(ki)) {
+      List *cast_list = Getattr(cast_data, ki.item);
+      Iterator ci_iter;
+      Printf(types, "  %s,\n", Getattr(type_data, ki.item));
+      Printf(type_names, "#define _swigt_%s swig_type_data[%d]\n", ki.item, i);
+      Printf(cast, " ");
+      for (ci_iter = First(cast_list); ci_iter.item; ci_iter = Next(ci_iter))
+	Printf(cast, " %s,", ci_iter.item);
+      Printf(cast, " {0, 0, 0, 0},\n");
+      Printf(cast_names, "#define _swigc_%s (swig_cast_data + %d)\n", ki.item, ci);
+      /* the cast list of each type ends with a null entry */
+      ci += Len(cast_list) + 1;
+      i++;
+    }
+    Printf(types, "};\n%s", type_names);
+    Printf(cast, "};\n%s", cast_names);
+    Delete(type_names);
+    Delete(cast_names);
+  }
+  i = 0;
   for (ki = First(table_list); ki.item; ki = Next(ki)) {
     Printf(f_forward, "#define SWIGTYPE%s swig_types[%d]\n", ki.item, i++);
     Printf(table, "  &_swigt_%s,\n", ki.item);
@@ -2289,5 +2320,7 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
   Delete(table);
   Delete(cast);
   Delete(cast_init);
+  Delete(type_data);
+  Delete(cast_data);
   Delete(imported_types);
 }